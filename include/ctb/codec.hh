@@ -0,0 +1,71 @@
+#pragma once
+
+#if !__cpp_concepts >= 201907L
+    #error "codec requires at least c++20"
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "namedtuple.hh"
+
+/* helpers shared by the binary encodings of namedtuples, wire.hh and msgpack.hh
+ */
+namespace ctb::namedtuple::details::codec {
+
+template<typename>
+constexpr bool is_std_string_ = false;
+
+template<typename Traits, typename Alloc>
+constexpr bool is_std_string_<::std::basic_string<char, Traits, Alloc>> = true;
+
+/* the chars of a String that are encoded, up to its first '\0'
+ */
+template<string::is_ctb_string T>
+[[nodiscard]]
+constexpr ::std::size_t str_length(T const& value) noexcept {
+    ::std::size_t size{};
+    while (size < T::size() && value.str.arr[size] != 0) {
+        ++size;
+    }
+    return size;
+}
+
+/* fill a String with `size` decoded chars, a String keeps its capacity so shorter values
+ * are padded with '\0'. false if they don't fit.
+ */
+template<string::is_ctb_string T>
+[[nodiscard]]
+constexpr bool assign_str(T& value, char const* const data, ::std::size_t const size) noexcept {
+    if (size > T::size()) {
+        return false;
+    }
+    for (::std::size_t i{}; i < T::size(); ++i) {
+        value.str.arr[i] = i < size ? data[i] : char{};
+    }
+    return true;
+}
+
+/* the bytes of a message left to read, every read fails once they are exhausted
+ */
+struct byte_reader {
+    ::std::byte const* it;
+    ::std::byte const* end;
+
+    [[nodiscard]]
+    constexpr ::std::size_t remaining() const noexcept {
+        return static_cast<::std::size_t>(this->end - this->it);
+    }
+
+    [[nodiscard]]
+    constexpr bool byte(::std::uint8_t& value) noexcept {
+        if (this->it == this->end) {
+            return false;
+        }
+        value = static_cast<::std::uint8_t>(*this->it++);
+        return true;
+    }
+};
+
+}  // namespace ctb::namedtuple::details::codec
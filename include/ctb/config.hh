@@ -0,0 +1,320 @@
+#pragma once
+
+#if !__cpp_concepts >= 201907L
+    #error "config requires at least c++20"
+#endif
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "namedtuple.hh"
+#include "perfect_hash.hh"
+
+namespace ctb::namedtuple::details::config {
+
+struct span {
+    ::std::size_t begin;
+    ::std::size_t end;
+};
+
+struct entry {
+    span key;
+    span value;
+};
+
+template<typename Char>
+[[nodiscard]]
+constexpr bool is_separator(Char const chr) noexcept {
+    return chr == ';' || chr == '\n';
+}
+
+template<typename Char>
+[[nodiscard]]
+constexpr bool is_blank(Char const chr) noexcept {
+    return chr == ' ' || chr == '\t' || chr == '\r';
+}
+
+/* split `text` into `key=value` entries separated by ';' or newlines,
+ * blank entries are skipped and blanks around keys and values are trimmed
+ *
+ * calls `on_entry(entry)` for every entry, returns false on a syntax error
+ */
+template<typename Text, typename OnEntry>
+[[nodiscard]]
+constexpr bool split(Text const& text, ::std::size_t const size, OnEntry&& on_entry) noexcept {
+    auto const trim = [&](span s) {
+        while (s.begin < s.end && is_blank(text[s.begin])) {
+            ++s.begin;
+        }
+        while (s.begin < s.end && is_blank(text[s.end - 1])) {
+            --s.end;
+        }
+        return s;
+    };
+
+    for (::std::size_t begin{}; begin < size;) {
+        auto end = begin;
+        while (end < size && !is_separator(text[end])) {
+            ++end;
+        }
+        auto const whole = trim(span{begin, end});
+        begin = end + 1;
+        if (whole.begin == whole.end) {
+            continue;
+        }
+
+        auto eq = whole.begin;
+        while (eq < whole.end && text[eq] != '=') {
+            ++eq;
+        }
+        auto const key = trim(span{whole.begin, eq});
+        if (eq == whole.end || key.begin == key.end) {
+            return false;
+        }
+        if (!on_entry(entry{key, trim(span{eq + 1, whole.end})})) {
+            return false;
+        }
+    }
+    return true;
+}
+
+enum class kind {
+    boolean,
+    integer,
+    string,
+};
+
+template<typename Text>
+[[nodiscard]]
+constexpr bool equal(Text const& text, span const s, char const* literal) noexcept {
+    for (auto i = s.begin; i < s.end; ++i, ++literal) {
+        if (*literal == '\0' || text[i] != *literal) {
+            return false;
+        }
+    }
+    return *literal == '\0';
+}
+
+template<typename Text>
+[[nodiscard]]
+constexpr bool is_integer(Text const& text, span s) noexcept {
+    if (s.begin < s.end && (text[s.begin] == '-' || text[s.begin] == '+')) {
+        ++s.begin;
+    }
+    if (s.begin == s.end) {
+        return false;
+    }
+    for (auto i = s.begin; i < s.end; ++i) {
+        if (text[i] < '0' || text[i] > '9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Text>
+[[nodiscard]]
+constexpr kind kind_of(Text const& text, span const s) noexcept {
+    if (equal(text, s, "true") || equal(text, s, "false")) {
+        return kind::boolean;
+    } else if (is_integer(text, s)) {
+        return kind::integer;
+    } else {
+        return kind::string;
+    }
+}
+
+/* parse an integer into T, returns false if it is malformed or out of T's range
+ */
+template<::std::integral T, typename Text>
+[[nodiscard]]
+constexpr bool parse_integer(Text const& text, span s, T& out) noexcept {
+    if (!is_integer(text, s)) {
+        return false;
+    }
+    auto const negative = text[s.begin] == '-';
+    if (text[s.begin] == '-' || text[s.begin] == '+') {
+        ++s.begin;
+    }
+    if (negative && ::std::is_unsigned_v<T>) {
+        return false;
+    }
+
+    // accumulate towards the sign so that the minimum of T doesn't overflow
+    T res{};
+    for (auto i = s.begin; i < s.end; ++i) {
+        auto const digit = static_cast<T>(text[i] - '0');
+        if (negative) {
+            if (res < (::std::numeric_limits<T>::min() + digit) / 10) {
+                return false;
+            }
+            res = static_cast<T>(res * 10 - digit);
+        } else {
+            if (res > (::std::numeric_limits<T>::max() - digit) / 10) {
+                return false;
+            }
+            res = static_cast<T>(res * 10 + digit);
+        }
+    }
+    out = res;
+    return true;
+}
+
+template<string::String Str>
+struct parsed {
+    static constexpr auto count = [] {
+        ::std::size_t res{};
+        [[maybe_unused]] auto const ok = split(Str.str, Str.size(), [&](entry) {
+            ++res;
+            return true;
+        });
+        return res;
+    }();
+
+    struct result {
+        bool valid;
+        ::std::array<entry, count> entries;
+    };
+
+    static constexpr auto value = [] {
+        result res{};
+        ::std::size_t index{};
+        res.valid = split(Str.str, Str.size(), [&](entry const e) {
+            res.entries[index++] = e;
+            return true;
+        });
+        return res;
+    }();
+};
+
+template<string::String Str, ::std::size_t I>
+[[nodiscard]]
+consteval auto name_of() noexcept {
+    constexpr auto key = parsed<Str>::value.entries[I].key;
+    return Str.template substr<key.begin, key.end - key.begin>();
+}
+
+template<string::String Str, ::std::size_t I>
+[[nodiscard]]
+consteval auto value_of() noexcept {
+    constexpr auto value = parsed<Str>::value.entries[I].value;
+    constexpr auto k = kind_of(Str.str, value);
+    if constexpr (k == kind::boolean) {
+        return equal(Str.str, value, "true");
+    } else if constexpr (k == kind::integer) {
+        constexpr auto res = [] {
+            struct {
+                bool ok;
+                long long value;
+            } res_{};
+            res_.ok = parse_integer(Str.str, parsed<Str>::value.entries[I].value, res_.value);
+            return res_;
+        }();
+        static_assert(res.ok, "ctb::namedtuple::parse_config: integer out of range of long long");
+        return res.value;
+    } else {
+        return Str.template substr<value.begin, value.end - value.begin>();
+    }
+}
+
+/* assign a runtime value to a field of the type the schema gave it
+ */
+template<string::is_char Char>
+[[nodiscard]]
+constexpr bool assign(bool& field, ::std::basic_string_view<Char> const text, span const s) noexcept {
+    if (equal(text, s, "true")) {
+        field = true;
+    } else if (equal(text, s, "false")) {
+        field = false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+template<::std::integral T, string::is_char Char>
+    requires (!::std::is_same_v<T, bool>)
+[[nodiscard]]
+constexpr bool assign(T& field, ::std::basic_string_view<Char> const text, span const s) noexcept {
+    return parse_integer(text, s, field);
+}
+
+/* a String field keeps its capacity, shorter values are padded with '\0'
+ * (which String compares equal to the unpadded value)
+ */
+template<string::is_char Char_l, ::std::size_t N, string::is_char Char>
+[[nodiscard]]
+constexpr bool assign(string::String<Char_l, N>& field, ::std::basic_string_view<Char> const text,
+                      span const s) noexcept {
+    if (s.end - s.begin > N - 1) {
+        return false;
+    }
+    for (::std::size_t i{}; i < N; ++i) {
+        auto const chr = s.begin + i < s.end ? text[s.begin + i] : Char{};
+        if (static_cast<Char_l>(chr) != chr) {
+            return false;
+        }
+        field.str.arr[i] = static_cast<Char_l>(chr);
+    }
+    return true;
+}
+
+}  // namespace ctb::namedtuple::details::config
+
+namespace ctb::namedtuple {
+
+/* parse a `key=value;key=value` string into a namedtuple at compile time
+ * entries may also be separated by newlines
+ *
+ * value types: `true`/`false` -> bool, integers -> long long, others -> String
+ *
+ * Usage: constexpr auto config = parse_config<"threads=8;batch=256;mode=fast">();
+ */
+template<string::String Str>
+[[nodiscard]]
+consteval auto parse_config() noexcept {
+    using parsed = details::config::parsed<Str>;
+    static_assert(parsed::value.valid, "ctb::namedtuple::parse_config: expected `key=value`");
+    static_assert(parsed::count > 0, "ctb::namedtuple::parse_config: empty config");
+
+    return []<::std::size_t... I>(::std::index_sequence<I...>) {
+        return NamedTuple<names<details::config::name_of<Str, I>()...>,
+                          decltype(details::config::value_of<Str, I>())...>{
+            details::config::value_of<Str, I>()...};
+    }(::std::make_index_sequence<parsed::count>{});
+}
+
+/* parse a config at runtime against the schema of `config`
+ *
+ * `config` holds the defaults, entries present in `text` overwrite them.
+ * returns false on a syntax error, an unknown key, or a value that does not
+ * fit its field; `config` may be partially updated then
+ *
+ * a String field keeps the capacity of its default, so `mode=fast` only takes values of
+ * up to 4 characters. to allow longer values, give the field a wider String in the schema.
+ *
+ * Usage:
+ *   auto config = parse_config<"threads=8;mode=fast">();
+ *   if (!parse_config(config, file_content)) { ... }
+ */
+template<is_namedtuple NT, string::is_char Char>
+[[nodiscard]]
+constexpr bool parse_config(NT& config, ::std::basic_string_view<Char> const text) noexcept {
+    using names_ = typename NT::names;
+    return details::config::split(text, text.size(), [&](details::config::entry const e) {
+        auto const index = find_name<names_>(text.substr(e.key.begin, e.key.end - e.key.begin));
+        return [&]<::std::size_t... I>(::std::index_sequence<I...>) {
+            bool ok{};
+            static_cast<void>(
+                ((index == I && (ok = details::config::assign(get<I>(config), text, e.value), true)) || ...));
+            return ok;
+        }(::std::make_index_sequence<::std::tuple_size_v<NT>>{});
+    });
+}
+
+}  // namespace ctb::namedtuple
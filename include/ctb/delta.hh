@@ -0,0 +1,295 @@
+#pragma once
+
+#if !__cpp_concepts >= 201907L
+    #error "delta requires at least c++20"
+#endif
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "namedtuple.hh"
+
+namespace ctb::namedtuple::details::delta {
+
+template<::std::size_t N>
+struct mask_ {
+    using type = ::std::array<::std::uint64_t, (N + 63) / 64>;
+};
+
+template<::std::size_t N>
+    requires (N <= 64)
+struct mask_<N> {
+    // clang-format off
+    using type = ::std::conditional_t<N <= 8, ::std::uint8_t,
+                 ::std::conditional_t<N <= 16, ::std::uint16_t,
+                 ::std::conditional_t<N <= 32, ::std::uint32_t, ::std::uint64_t>>>;
+    // clang-format on
+};
+
+/* the narrowest mask with a bit per field
+ */
+template<::std::size_t N>
+using mask_t = typename mask_<N>::type;
+
+template<typename Mask>
+constexpr void set_bit(Mask& mask, ::std::size_t const i) noexcept {
+    if constexpr (::std::is_integral_v<Mask>) {
+        mask = static_cast<Mask>(mask | Mask{1} << i);
+    } else {
+        mask[i / 64] |= ::std::uint64_t{1} << i % 64;
+    }
+}
+
+template<typename Mask>
+[[nodiscard]]
+constexpr bool test_bit(Mask const& mask, ::std::size_t const i) noexcept {
+    if constexpr (::std::is_integral_v<Mask>) {
+        return (mask >> i & 1) != 0;
+    } else {
+        return (mask[i / 64] >> i % 64 & 1) != 0;
+    }
+}
+
+template<typename>
+constexpr ::std::size_t capacity_ = 0;
+
+template<is_names Names, typename... Args>
+constexpr ::std::size_t capacity_<NamedTuple<Names, Args...>> = (sizeof(Args) + ...);
+
+}  // namespace ctb::namedtuple::details::delta
+
+namespace ctb::namedtuple {
+
+/* the changed fields of a namedtuple: bit I of `mask` is set if field I changed,
+ * and the first `size` bytes of `values` are the changed fields packed in field order
+ */
+template<is_namedtuple NT>
+struct Delta {
+    using mask_type = details::delta::mask_t<::std::tuple_size_v<NT>>;
+
+    mask_type mask{};
+    ::std::size_t size{};
+    ::std::array<::std::byte, details::delta::capacity_<NT>> values{};
+
+    template<::std::size_t I>
+    [[nodiscard]]
+    constexpr bool changed() const noexcept {
+        return details::delta::test_bit(this->mask, I);
+    }
+
+    [[nodiscard]]
+    constexpr bool empty() const noexcept {
+        return this->size == 0;
+    }
+};
+
+namespace details::delta {
+
+template<typename NT>
+concept can_delta = ::std::is_trivially_copyable_v<NT> && is_namedtuple<NT>;
+
+template<typename T>
+constexpr bool comparable_ = ::std::equality_comparable<T>;
+
+template<is_names Names, typename... Args>
+constexpr bool comparable_<NamedTuple<Names, Args...>> = (comparable_<Args> && ...);
+
+/* every field can be compared with ==, fields that are namedtuples are compared field by field
+ */
+template<typename NT>
+concept can_diff = can_delta<NT> && comparable_<NT>;
+
+template<typename T>
+[[nodiscard]]
+constexpr bool equal(T const& lhs, T const& rhs) noexcept {
+    if constexpr (is_namedtuple<T>) {
+        return [&]<::std::size_t... I>(::std::index_sequence<I...>) {
+            return (equal(get<I>(lhs), get<I>(rhs)) && ...);
+        }(::std::make_index_sequence<::std::tuple_size_v<T>>{});
+    } else {
+        return lhs == rhs;
+    }
+}
+
+/* the number of bytes of the fields set in `mask`, or 0 if a bit is set past the last field
+ */
+template<typename NT, typename Mask>
+[[nodiscard]]
+constexpr ::std::size_t size_of(Mask const& mask) noexcept {
+    constexpr auto fields = ::std::tuple_size_v<NT>;
+    for (auto i = fields; i < sizeof(Mask) * 8; ++i) {
+        if (test_bit(mask, i)) {
+            return 0;
+        }
+    }
+    return [&]<::std::size_t... I>(::std::index_sequence<I...>) {
+        return ((test_bit(mask, I) ? sizeof(::std::tuple_element_t<I, NT>) : 0) + ...);
+    }(::std::make_index_sequence<fields>{});
+}
+
+/* append field I of `nt` to `delta`
+ */
+template<::std::size_t I, typename NT>
+void record(Delta<NT>& delta, NT const& nt) noexcept {
+    set_bit(delta.mask, I);
+    ::std::memcpy(delta.values.data() + delta.size, &get<I>(nt), sizeof(get<I>(nt)));
+    delta.size += sizeof(get<I>(nt));
+}
+
+}  // namespace details::delta
+
+/* the fields that differ between `old_nt` and `new_nt`, with the values of `new_nt`
+ *
+ * fields are compared with ==, except nested namedtuples which differ if any of their fields does,
+ * and are then recorded whole
+ *
+ * Usage: auto delta = diff(old_nt, new_nt);
+ */
+template<details::delta::can_diff NT>
+[[nodiscard]]
+Delta<NT> diff(NT const& old_nt, NT const& new_nt) noexcept {
+    auto delta = Delta<NT>{};
+    [&]<::std::size_t... I>(::std::index_sequence<I...>) {
+        ((details::delta::equal(get<I>(old_nt), get<I>(new_nt)) || (details::delta::record<I>(delta, new_nt), true)),
+         ...);
+    }(::std::make_index_sequence<::std::tuple_size_v<NT>>{});
+    return delta;
+}
+
+/* write the changed fields of `delta` into `nt`
+ *
+ * Usage: apply_delta(nt, diff(nt, other));  // nt == other
+ */
+template<details::delta::can_delta NT>
+void apply_delta(NT& nt, Delta<NT> const& delta) noexcept {
+    ::std::size_t offset{};
+    [&]<::std::size_t... I>(::std::index_sequence<I...>) {
+        (
+            [&] {
+                if (delta.template changed<I>()) {
+                    ::std::memcpy(&get<I>(nt), delta.values.data() + offset, sizeof(get<I>(nt)));
+                    offset += sizeof(get<I>(nt));
+                }
+            }(),
+            ...);
+    }(::std::make_index_sequence<::std::tuple_size_v<NT>>{});
+}
+
+/* append `delta` to `out` as its mask followed by the changed fields, in native byte order,
+ * so it takes only as many bytes as the fields that changed
+ *
+ * Usage:
+ *   auto bytes = ::std::vector<::std::byte>{};
+ *   encode_delta(diff(old_nt, new_nt), bytes);
+ */
+template<details::delta::can_delta NT>
+void encode_delta(Delta<NT> const& delta, ::std::vector<::std::byte>& out) {
+    auto const* const mask = reinterpret_cast<::std::byte const*>(&delta.mask);
+    out.insert(out.end(), mask, mask + sizeof(delta.mask));
+    out.insert(out.end(), delta.values.begin(), delta.values.begin() + static_cast<::std::ptrdiff_t>(delta.size));
+}
+
+/* read a delta written by `encode_delta`, returns false if `bytes` is not one
+ *
+ * Usage: if (auto delta = Delta<NT>{}; decode_delta(delta, ::std::span{bytes})) { apply_delta(nt, delta); }
+ */
+template<details::delta::can_delta NT>
+[[nodiscard]]
+bool decode_delta(Delta<NT>& delta, ::std::span<::std::byte const> const bytes) noexcept {
+    using mask_type = typename Delta<NT>::mask_type;
+    if (bytes.size() < sizeof(mask_type)) {
+        return false;
+    }
+    auto mask = mask_type{};
+    ::std::memcpy(&mask, bytes.data(), sizeof(mask));
+    auto const size = details::delta::size_of<NT>(mask);
+    if (bytes.size() != sizeof(mask) + size || (size == 0 && mask != mask_type{})) {
+        return false;
+    }
+    delta.mask = mask;
+    delta.size = size;
+    ::std::memcpy(delta.values.data(), bytes.data() + sizeof(mask), size);
+    return true;
+}
+
+/* a namedtuple that remembers which fields were written since the last `take_delta()`
+ *
+ * writing through `set<"f">` or the non-const `get<"f">` marks a field dirty,
+ * so writers can persist only the fields that changed.
+ */
+template<details::delta::can_delta NT>
+struct TrackedNamedTuple {
+    using names = typename NT::names;
+    using mask_type = typename Delta<NT>::mask_type;
+
+    NT value;
+    mask_type dirty{};
+
+    template<::std::size_t I>
+    [[nodiscard]]
+    constexpr bool is_dirty() const noexcept {
+        return details::delta::test_bit(this->dirty, I);
+    }
+
+    template<string::String str>
+    [[nodiscard]]
+    constexpr bool is_dirty() const noexcept {
+        return this->is_dirty<details::get_index<str, names>()>();
+    }
+
+    /* the dirty fields with their current values, and mark every field clean
+     */
+    [[nodiscard]]
+    Delta<NT> take_delta() noexcept {
+        auto delta = Delta<NT>{};
+        [&]<::std::size_t... I>(::std::index_sequence<I...>) {
+            ((this->is_dirty<I>() ? details::delta::record<I>(delta, this->value) : void()), ...);
+        }(::std::make_index_sequence<::std::tuple_size_v<NT>>{});
+        this->dirty = mask_type{};
+        return delta;
+    }
+};
+
+/* Usage: auto tracked = tracked_namedtuple(make_namedtuple<"a", "b">(1, 2));
+ */
+template<details::delta::can_delta NT>
+[[nodiscard]]
+constexpr auto tracked_namedtuple(NT const& nt) noexcept {
+    return TrackedNamedTuple<NT>{nt};
+}
+
+/* read a field, without marking it dirty
+ */
+template<string::String str, typename NT>
+[[nodiscard]]
+constexpr auto get(TrackedNamedTuple<NT> const& tracked) noexcept -> decltype(auto) {
+    return get<str>(tracked.value);
+}
+
+/* get a field for writing, which marks it dirty
+ */
+template<string::String str, typename NT>
+[[nodiscard]]
+constexpr auto get(TrackedNamedTuple<NT>& tracked) noexcept -> decltype(auto) {
+    details::delta::set_bit(tracked.dirty, details::get_index<str, typename NT::names>());
+    return get<str>(tracked.value);
+}
+
+/* write a field and mark it dirty
+ *
+ * Usage: set<"a">(tracked, 3)
+ */
+template<string::String str, typename NT, typename T>
+constexpr void set(TrackedNamedTuple<NT>& tracked, T&& value) noexcept {
+    get<str>(tracked) = ::std::forward<T>(value);
+}
+
+}  // namespace ctb::namedtuple
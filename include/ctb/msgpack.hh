@@ -0,0 +1,457 @@
+#pragma once
+
+#if !__cpp_concepts >= 201907L
+    #error "msgpack requires at least c++20"
+#endif
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "codec.hh"
+#include "namedtuple.hh"
+#include "perfect_hash.hh"
+
+namespace ctb::namedtuple::details::msgpack {
+
+/* the size of the string header, 0 if the string is too long for msgpack
+ */
+[[nodiscard]]
+constexpr ::std::size_t str_header_size(::std::size_t const size) noexcept {
+    return size < 32 ? 1 : size <= 0xff ? 2 : size <= 0xffff ? 3 : size <= 0xffff'ffff ? 5 : 0;
+}
+
+/* write the big endian `size` bytes of `value`
+ */
+constexpr ::std::byte* put_big_endian(::std::byte* out, ::std::uint64_t const value,
+                                      ::std::size_t const size) noexcept {
+    for (auto i = size; i-- > 0;) {
+        *out++ = static_cast<::std::byte>(value >> i * 8 & 0xff);
+    }
+    return out;
+}
+
+constexpr ::std::byte* put_str_header(::std::byte* out, ::std::size_t const size) noexcept {
+    switch (str_header_size(size)) {
+    case 1:
+        *out++ = static_cast<::std::byte>(0xa0 | size);
+        return out;
+    case 2:
+        *out++ = ::std::byte{0xd9};
+        return put_big_endian(out, size, 1);
+    case 3:
+        *out++ = ::std::byte{0xda};
+        return put_big_endian(out, size, 2);
+    default:
+        *out++ = ::std::byte{0xdb};
+        return put_big_endian(out, size, 4);
+    }
+}
+
+/* the msgpack bytes of a name used as a key, built at compile time
+ */
+template<string::String Str>
+constexpr auto key = [] {
+    static_assert(sizeof(typename decltype(Str)::value_type) == 1, "msgpack keys must be narrow strings");
+    constexpr auto size = Str.size();
+    ::std::array<::std::byte, str_header_size(size) + size> res{};
+    auto* out = put_str_header(res.data(), size);
+    for (::std::size_t i{}; i < size; ++i) {
+        *out++ = static_cast<::std::byte>(Str.str.arr[i]);
+    }
+    return res;
+}();
+
+inline void put(::std::vector<::std::byte>& out, ::std::byte const type, ::std::uint64_t const value,
+                ::std::size_t const size) {
+    ::std::byte bytes[9]{type};
+    out.insert(out.end(), bytes, put_big_endian(bytes + 1, value, size));
+}
+
+inline void put_map_header(::std::vector<::std::byte>& out, ::std::size_t const size) {
+    if (size < 16) {
+        out.push_back(static_cast<::std::byte>(0x80 | size));
+    } else if (size <= 0xffff) {
+        put(out, ::std::byte{0xde}, size, 2);
+    } else {
+        put(out, ::std::byte{0xdf}, size, 4);
+    }
+}
+
+inline void put_uint(::std::vector<::std::byte>& out, ::std::uint64_t const value) {
+    if (value < 0x80) {
+        out.push_back(static_cast<::std::byte>(value));
+    } else if (value <= 0xff) {
+        put(out, ::std::byte{0xcc}, value, 1);
+    } else if (value <= 0xffff) {
+        put(out, ::std::byte{0xcd}, value, 2);
+    } else if (value <= 0xffff'ffff) {
+        put(out, ::std::byte{0xce}, value, 4);
+    } else {
+        put(out, ::std::byte{0xcf}, value, 8);
+    }
+}
+
+inline void put_int(::std::vector<::std::byte>& out, ::std::int64_t const value) {
+    auto const bits = static_cast<::std::uint64_t>(value);
+    if (value >= 0) {
+        put_uint(out, bits);
+    } else if (value >= -32) {
+        out.push_back(static_cast<::std::byte>(bits & 0xff));
+    } else if (value >= ::std::numeric_limits<::std::int8_t>::min()) {
+        put(out, ::std::byte{0xd0}, bits, 1);
+    } else if (value >= ::std::numeric_limits<::std::int16_t>::min()) {
+        put(out, ::std::byte{0xd1}, bits, 2);
+    } else if (value >= ::std::numeric_limits<::std::int32_t>::min()) {
+        put(out, ::std::byte{0xd2}, bits, 4);
+    } else {
+        put(out, ::std::byte{0xd3}, bits, 8);
+    }
+}
+
+/* throws ::std::length_error for strings msgpack can't hold, nothing is written then
+ */
+inline void put_str(::std::vector<::std::byte>& out, char const* const data, ::std::size_t const size) {
+    if (str_header_size(size) == 0) {
+        throw ::std::length_error{"ctb::namedtuple::encode_msgpack: string longer than 4 GiB"};
+    }
+    ::std::byte header[5];
+    out.insert(out.end(), header, put_str_header(header, size));
+    auto const* const bytes = reinterpret_cast<::std::byte const*>(data);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+template<typename NT>
+void encode(NT const& nt, ::std::vector<::std::byte>& out);
+
+/* the format of a value is picked from its type:
+ *   bool                   -> true/false
+ *   integers, enums        -> the smallest int/uint format holding the value
+ *   float, double          -> float 32/float 64
+ *   String<char>, string   -> str, up to the first '\0' for String
+ *   namedtuple             -> map
+ */
+template<typename T>
+void put_value(T const& value, ::std::vector<::std::byte>& out) {
+    if constexpr (::std::is_same_v<T, bool>) {
+        out.push_back(value ? ::std::byte{0xc3} : ::std::byte{0xc2});
+    } else if constexpr (::std::is_enum_v<T>) {
+        put_value(static_cast<::std::underlying_type_t<T>>(value), out);
+    } else if constexpr (::std::is_integral_v<T> && ::std::is_signed_v<T>) {
+        put_int(out, value);
+    } else if constexpr (::std::is_integral_v<T>) {
+        put_uint(out, value);
+    } else if constexpr (::std::is_same_v<T, float>) {
+        put(out, ::std::byte{0xca}, ::std::bit_cast<::std::uint32_t>(value), 4);
+    } else if constexpr (::std::is_same_v<T, double>) {
+        put(out, ::std::byte{0xcb}, ::std::bit_cast<::std::uint64_t>(value), 8);
+    } else if constexpr (codec::is_std_string_<T>) {
+        put_str(out, value.data(), value.size());
+    } else if constexpr (string::is_ctb_string<T>) {
+        static_assert(::std::is_same_v<typename T::value_type, char>, "only char Strings can be encoded");
+        put_str(out, value.str.arr, codec::str_length(value));
+    } else if constexpr (is_namedtuple<T>) {
+        encode(value, out);
+    } else {
+        static_assert(!sizeof(T), "this type has no msgpack encoding");
+    }
+}
+
+template<typename NT>
+void encode(NT const& nt, ::std::vector<::std::byte>& out) {
+    put_map_header(out, ::std::tuple_size_v<NT>);
+    [&]<auto... Keys, ::std::size_t... I>(names<Keys...>*, ::std::index_sequence<I...>) {
+        ((out.insert(out.end(), key<name_of<Keys>>.begin(), key<name_of<Keys>>.end()), put_value(get<I>(nt), out)),
+         ...);
+    }(static_cast<typename NT::names*>(nullptr), ::std::make_index_sequence<::std::tuple_size_v<NT>>{});
+}
+
+/* the reading side of a message, every read fails once the input is exhausted or malformed
+ */
+struct reader : codec::byte_reader {
+    [[nodiscard]]
+    constexpr bool big_endian(::std::uint64_t& value, ::std::size_t const size) noexcept {
+        if (this->remaining() < size) {
+            return false;
+        }
+        value = 0;
+        for (::std::size_t i{}; i < size; ++i) {
+            value = value << 8 | static_cast<::std::uint64_t>(*this->it++);
+        }
+        return true;
+    }
+
+    /* the bytes of a str, without copying them
+     */
+    [[nodiscard]]
+    constexpr bool str(::std::string_view& value) noexcept {
+        ::std::uint8_t type;
+        ::std::uint64_t size;
+        if (!this->byte(type)) {
+            return false;
+        }
+        if ((type & 0xe0) == 0xa0) {
+            size = type & 0x1f;
+        } else if (type < 0xd9 || type > 0xdb || !this->big_endian(size, ::std::size_t{1} << (type - 0xd9))) {
+            return false;
+        }
+        if (size > this->remaining()) {
+            return false;
+        }
+        value = ::std::string_view{reinterpret_cast<char const*>(this->it), static_cast<::std::size_t>(size)};
+        this->it += size;
+        return true;
+    }
+
+    [[nodiscard]]
+    constexpr bool map_header(::std::uint64_t& size) noexcept {
+        ::std::uint8_t type;
+        if (!this->byte(type)) {
+            return false;
+        }
+        if ((type & 0xf0) == 0x80) {
+            size = type & 0x0f;
+            return true;
+        }
+        return (type == 0xde || type == 0xdf) && this->big_endian(size, type == 0xde ? 2 : 4);
+    }
+
+    /* an integer of any int/uint format, `negative` is set for the int formats
+     * holding a negative value, whose two's complement is then in `value`
+     */
+    [[nodiscard]]
+    constexpr bool integer(::std::uint64_t& value, bool& negative) noexcept {
+        ::std::uint8_t type;
+        if (!this->byte(type)) {
+            return false;
+        }
+        negative = false;
+        if (type < 0x80) {
+            value = type;
+            return true;
+        }
+        if (type >= 0xe0) {
+            value = static_cast<::std::uint64_t>(static_cast<::std::int8_t>(type));
+            negative = true;
+            return true;
+        }
+        if (type >= 0xcc && type <= 0xcf) {
+            return this->big_endian(value, ::std::size_t{1} << (type - 0xcc));
+        }
+        if (type >= 0xd0 && type <= 0xd3) {
+            auto const size = ::std::size_t{1} << (type - 0xd0);
+            if (!this->big_endian(value, size)) {
+                return false;
+            }
+            // sign extend
+            auto const shift = 64 - size * 8;
+            value = static_cast<::std::uint64_t>(static_cast<::std::int64_t>(value << shift) >> shift);
+            negative = static_cast<::std::int64_t>(value) < 0;
+            return true;
+        }
+        return false;
+    }
+
+    /* skip any value, containers included
+     */
+    [[nodiscard]]
+    constexpr bool skip(::std::size_t const depth = 0) noexcept {
+        ::std::uint8_t type;
+        if (depth > 64 || !this->byte(type)) {
+            return false;
+        }
+        ::std::uint64_t size{};
+        ::std::uint64_t items{};
+        if (type < 0x80 || type >= 0xe0 || type == 0xc0 || type == 0xc2 || type == 0xc3) {
+            return true;
+        } else if ((type & 0xf0) == 0x80) {
+            items = 2 * (type & 0x0f);
+        } else if ((type & 0xf0) == 0x90) {
+            items = type & 0x0f;
+        } else if ((type & 0xe0) == 0xa0) {
+            size = type & 0x1f;
+        } else if (type >= 0xc4 && type <= 0xc6) {  // bin
+            if (!this->big_endian(size, ::std::size_t{1} << (type - 0xc4))) {
+                return false;
+            }
+        } else if (type >= 0xc7 && type <= 0xc9) {  // ext
+            if (!this->big_endian(size, ::std::size_t{1} << (type - 0xc7))) {
+                return false;
+            }
+            ++size;
+        } else if (type == 0xca || type == 0xcb) {
+            size = type == 0xca ? 4 : 8;
+        } else if (type >= 0xcc && type <= 0xd3) {
+            size = ::std::size_t{1} << ((type - 0xcc) % 4);
+        } else if (type >= 0xd4 && type <= 0xd8) {  // fixext
+            size = (::std::size_t{1} << (type - 0xd4)) + 1;
+        } else if (type >= 0xd9 && type <= 0xdb) {
+            if (!this->big_endian(size, ::std::size_t{1} << (type - 0xd9))) {
+                return false;
+            }
+        } else if (type == 0xdc || type == 0xdd) {
+            if (!this->big_endian(items, type == 0xdc ? 2 : 4)) {
+                return false;
+            }
+        } else if (type == 0xde || type == 0xdf) {
+            if (!this->big_endian(items, type == 0xde ? 2 : 4)) {
+                return false;
+            }
+            items *= 2;
+        } else {
+            return false;
+        }
+        if (size > this->remaining()) {
+            return false;
+        }
+        this->it += size;
+        for (; items > 0; --items) {
+            if (!this->skip(depth + 1)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+template<typename NT>
+[[nodiscard]]
+bool decode(NT& nt, reader& in);
+
+template<typename T>
+[[nodiscard]]
+bool get_value(T& value, reader& in) {
+    if constexpr (::std::is_same_v<T, bool>) {
+        ::std::uint8_t type;
+        if (!in.byte(type) || type != 0xc2 && type != 0xc3) {
+            return false;
+        }
+        value = type == 0xc3;
+        return true;
+    } else if constexpr (::std::is_enum_v<T>) {
+        auto underlying = static_cast<::std::underlying_type_t<T>>(value);
+        if (!get_value(underlying, in)) {
+            return false;
+        }
+        value = static_cast<T>(underlying);
+        return true;
+    } else if constexpr (::std::is_integral_v<T>) {
+        ::std::uint64_t raw;
+        bool negative;
+        if (!in.integer(raw, negative)) {
+            return false;
+        }
+        // the value must fit in the field
+        if constexpr (::std::is_signed_v<T>) {
+            auto const wide = static_cast<::std::int64_t>(raw);
+            if (!negative && wide < 0) {
+                return false;
+            }
+            value = static_cast<T>(wide);
+            return value == wide;
+        } else {
+            value = static_cast<T>(raw);
+            return !negative && static_cast<::std::uint64_t>(value) == raw;
+        }
+    } else if constexpr (::std::is_floating_point_v<T>) {
+        ::std::uint8_t type;
+        ::std::uint64_t raw;
+        if (!in.byte(type) || type != 0xca && type != 0xcb || !in.big_endian(raw, type == 0xca ? 4 : 8)) {
+            return false;
+        }
+        value = type == 0xca ? static_cast<T>(::std::bit_cast<float>(static_cast<::std::uint32_t>(raw)))
+                             : static_cast<T>(::std::bit_cast<double>(raw));
+        return true;
+    } else if constexpr (codec::is_std_string_<T>) {
+        ::std::string_view str;
+        if (!in.str(str)) {
+            return false;
+        }
+        value.assign(str);
+        return true;
+    } else if constexpr (string::is_ctb_string<T>) {
+        ::std::string_view str;
+        return in.str(str) && codec::assign_str(value, str.data(), str.size());
+    } else {
+        return decode(value, in);
+    }
+}
+
+/* keys are looked up with the perfect hash of the names, fields missing from
+ * the map keep their value, and unknown keys are skipped
+ */
+template<typename NT>
+bool decode(NT& nt, reader& in) {
+    ::std::uint64_t size;
+    if (!in.map_header(size)) {
+        return false;
+    }
+    for (; size > 0; --size) {
+        ::std::string_view name;
+        if (!in.str(name)) {
+            return false;
+        }
+        auto const index = find_name<typename NT::names>(name);
+        if (index == ::std::tuple_size_v<NT>) {
+            if (!in.skip()) {
+                return false;
+            }
+            continue;
+        }
+        auto const ok = [&]<::std::size_t... I>(::std::index_sequence<I...>) {
+            auto res = false;
+            static_cast<void>(((index == I && (res = get_value(get<I>(nt), in), true)) || ...));
+            return res;
+        }(::std::make_index_sequence<::std::tuple_size_v<NT>>{});
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace ctb::namedtuple::details::msgpack
+
+namespace ctb::namedtuple {
+
+/* append the MessagePack encoding of `nt` to `out`, a map from the names to the values
+ *
+ * the keys are encoded once at compile time and copied as they are. throws
+ * ::std::length_error for a string of 4 GiB or more, which msgpack can't hold
+ *
+ * Usage:
+ *   auto bytes = ::std::vector<::std::byte>{};
+ *   encode_msgpack(nt, bytes);
+ */
+template<is_namedtuple NT>
+void encode_msgpack(NT const& nt, ::std::vector<::std::byte>& out) {
+    details::msgpack::encode(nt, out);
+}
+
+/* decode a MessagePack map into `nt`
+ *
+ * keys may come in any order, fields missing from the map keep their value,
+ * and keys unknown to `NT` are skipped along with their values. returns false
+ * if the message is malformed or a value doesn't fit its field, `nt` may then
+ * be partially written.
+ *
+ * Usage: if (decode_msgpack(nt, ::std::span{bytes})) { ... }
+ */
+template<is_namedtuple NT>
+[[nodiscard]]
+bool decode_msgpack(NT& nt, ::std::span<::std::byte const> const bytes) {
+    auto in = details::msgpack::reader{{bytes.data(), bytes.data() + bytes.size()}};
+    return details::msgpack::decode(nt, in) && in.it == in.end;
+}
+
+}  // namespace ctb::namedtuple
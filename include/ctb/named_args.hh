@@ -0,0 +1,90 @@
+#pragma once
+
+#if !__cpp_concepts >= 201907L
+    #error "named_args requires at least c++20"
+#endif
+
+#include <type_traits>
+#include <utility>
+
+#include "namedtuple.hh"
+
+namespace ctb::namedtuple {
+
+/* an argument bound to a name, it only refers to the value,
+ * so it must be consumed within the full expression that created it
+ */
+template<string::String Name, typename T>
+struct named_arg {
+    static constexpr auto name{Name};
+    T&& value;
+};
+
+namespace details {
+
+template<string::String Name>
+struct arg_t {
+    template<typename T>
+    [[nodiscard]]
+    constexpr auto operator=(T&& value) const noexcept {
+        return named_arg<Name, T>{::std::forward<T>(value)};
+    }
+};
+
+template<typename>
+constexpr bool is_named_arg_ = false;
+
+template<string::String Name, typename T>
+constexpr bool is_named_arg_<named_arg<Name, T>> = true;
+
+template<typename T>
+concept is_named_arg = is_named_arg_<::std::remove_cvref_t<T>>;
+
+/* the names the arguments are bound to, in call order
+ */
+template<is_named_arg... NamedArgs>
+using arg_names = names<key_of<::std::remove_cvref_t<NamedArgs>::name>...>;
+
+}  // namespace details
+
+/* Usage: arg<"retries"> = 3
+ */
+template<string::String Name>
+constexpr details::arg_t<Name> arg{};
+
+/* call `func` with the fields of `Schema` as positional arguments, in schema order
+ * fields missing from `args` are passed their defaults
+ *
+ * Usage:
+ *   using options = schema<field<"timeout", int, 30>, field<"retries", int, 3>>;
+ *   invoke_named<options>(connect, arg<"retries"> = 5);  // connect(30, 5)
+ */
+template<details::is_schema Schema, typename Func, details::is_named_arg... NamedArgs>
+constexpr auto invoke_named(Func&& func, NamedArgs&&... args) -> decltype(auto) {
+    static_assert(details::all_known<typename Schema::names, ::std::remove_cvref_t<NamedArgs>::name...>(),
+                  "ctb::namedtuple::invoke_named: name not in schema");
+    if constexpr (sizeof...(NamedArgs) != 0) {
+        static_assert(details::unique_names<details::arg_names<NamedArgs...>>,
+                      "ctb::namedtuple::invoke_named: name given twice");
+    }
+    return []<details::is_field... Fields>(schema<Fields...>*, Func&& func_, NamedArgs&&... args_) -> decltype(auto) {
+        return ::std::forward<Func>(func_)(details::pick_field<Fields, ::std::remove_cvref_t<NamedArgs>::name...>(
+            ::std::forward<decltype(args_.value)>(args_.value)...)...);
+    }(static_cast<Schema*>(nullptr), ::std::forward<Func>(func), ::std::forward<NamedArgs>(args)...);
+}
+
+/* make a namedtuple of `Schema` from named arguments
+ *
+ * Usage: make_namedtuple<options>(arg<"retries"> = 5)
+ */
+template<details::is_schema Schema, details::is_named_arg... NamedArgs>
+    requires (sizeof...(NamedArgs) > 0)
+[[nodiscard]]
+constexpr auto make_namedtuple(NamedArgs&&... args) noexcept {
+    static_assert(details::unique_names<details::arg_names<NamedArgs...>>,
+                  "ctb::namedtuple::make_namedtuple: name given twice");
+    return make_namedtuple<Schema, ::std::remove_cvref_t<NamedArgs>::name...>(
+        ::std::forward<decltype(args.value)>(args.value)...);
+}
+
+}  // namespace ctb::namedtuple
@@ -4,8 +4,14 @@
     #error "namedtuple requires at least c++20"
 #endif
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
 #include <tuple>
 #include <type_traits>
+#include <utility>
 
 #ifdef CTB_N_STL_SUPPORT
     #include "string.hh"
@@ -17,96 +23,869 @@
 
 namespace ctb::namedtuple::details {
 
-template<string::String First, string::String... Rest>
-struct names : names<Rest...> {
-    static constexpr auto current_val{First};
-    using next_name = names<Rest...>;
+#ifdef CTB_N_HASHED_NAMES
+
+    /* name_of relies on friend injection, which is only tested with gcc. a collision is only caught
+     * inside a translation unit: two names with the same hash in different translation units break
+     * the one definition rule of `text` without a diagnostic.
+     */
+    #if !defined(__GNUC__) || defined(__clang__)
+        #error "CTB_N_HASHED_NAMES is only supported with gcc"
+    #endif
+
+namespace hashed {
+
+template<string::String Str>
+[[nodiscard]]
+consteval ::std::uint64_t hash() noexcept {
+    auto res = ::std::uint64_t{0xcbf2'9ce4'8422'2325};
+    for (auto const chr : Str) {
+        res = (res ^ static_cast<::std::make_unsigned_t<decltype(chr)>>(chr)) * 0x100'0000'01b3;
+    }
+    return res;
+}
+
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wnon-template-friend"
+
+/* `text(tag<Key>{})` is the name whose hash is `Key`, it is defined by `intern` of that name
+ */
+template<::std::uint64_t Key>
+struct tag {
+    friend constexpr auto text(tag) noexcept;
+};
+
+    #pragma GCC diagnostic pop
+
+/* two names with the same hash define `text` twice, so a collision fails to compile
+ */
+template<string::String Str>
+struct intern {
+    static constexpr ::std::uint64_t value = hash<Str>();
+
+    friend constexpr auto text(tag<value>) noexcept {
+        return Str;
+    }
 };
 
+}  // namespace hashed
+
+/* with CTB_N_HASHED_NAMES, names are carried in types as their 64-bit hash
+ * instead of their text, which keeps mangled symbols and debug info short.
+ * every name is converted to utf-8 first, so "id" and u8"id" are the same name.
+ */
 template<string::String Str>
-struct names<Str> {
-    static constexpr auto current_val{Str};
+constexpr ::std::uint64_t key_of = hashed::intern<string::code_cvt<char>(Str)>::value;
+
+template<::std::uint64_t Key>
+constexpr auto name_of = text(hashed::tag<Key>{});
+
+#else
+
+/* without CTB_N_HASHED_NAMES, a name is carried in types as its text
+ */
+template<string::String Str>
+constexpr auto key_of = Str;
+
+template<string::String Key>
+constexpr auto name_of = Key;
+
+#endif  // CTB_N_HASHED_NAMES
+
+/* a list of names, flat rather than one base per name so that long lists
+ * don't run into the template instantiation depth limit
+ */
+template<auto First, auto... Rest>
+struct names {
+    static constexpr auto current_val{name_of<First>};
+    using next_name = names<Rest...>;
+};
+
+template<auto Key>
+struct names<Key> {
+    static constexpr auto current_val{name_of<Key>};
     using next_name = void;
 };
 
 template<typename>
 constexpr bool is_names_ = false;
 
-template<string::String... Str>
-constexpr bool is_names_<names<Str...>> = true;
+template<auto... Keys>
+constexpr bool is_names_<names<Keys...>> = true;
 
 template<typename T>
 concept is_names = is_names_<::std::remove_cvref_t<T>>;
 
-template<::std::size_t N, is_names Names, ::std::size_t index_ = 0>
+template<::std::size_t I, auto Key>
+struct name_at_ {};
+
+template<typename Names, typename Indexes>
+struct indexed_names_;
+
+template<auto... Keys, ::std::size_t... I>
+struct indexed_names_<names<Keys...>, ::std::index_sequence<I...>> : name_at_<I, Keys>... {};
+
+template<::std::size_t N, auto Key>
+consteval auto pick_name(name_at_<N, Key> const*) noexcept {
+    return name_of<Key>;
+}
+
+template<is_names Names>
+struct get_size_;
+
+template<auto... Keys>
+struct get_size_<names<Keys...>> : ::std::integral_constant<::std::size_t, sizeof...(Keys)> {};
+
+template<is_names Names>
+[[nodiscard]]
+consteval ::std::size_t get_size() noexcept {
+    return get_size_<Names>::value;
+}
+
+/* the name at index `N`, picked by overload resolution over all the names at once
+ */
+template<::std::size_t N, is_names Names>
 [[nodiscard]]
 consteval auto get_name() noexcept {
-    if constexpr (index_ == N) {
-        return Names::current_val;
-    } else {
-        static_assert(!::std::is_void_v<typename Names::next_name>, "index out of range");
-        return get_name<N, typename Names::next_name, index_ + 1>();
-    }
+    static_assert(N < get_size<Names>(), "index out of range");
+    using indexed = indexed_names_<Names, ::std::make_index_sequence<get_size<Names>()>>;
+    return pick_name<N>(static_cast<indexed const*>(nullptr));
 }
 
-template<is_names Names, ::std::size_t counter = 0>
+template<string::String Str, is_names Names>
+struct get_index_;
+
+template<string::String Str, auto... Keys>
+struct get_index_<Str, names<Keys...>> {
+    static consteval ::std::size_t find() noexcept {
+        bool const matches[]{(Keys == key_of<Str>)...};
+        for (::std::size_t i{}; i < sizeof...(Keys); ++i) {
+            if (matches[i]) {
+                return i;
+            }
+        }
+        return sizeof...(Keys);
+    }
+};
+
+namespace unique {
+
+template<typename Char>
 [[nodiscard]]
-consteval ::std::size_t get_size() noexcept {
-    if constexpr (::std::is_void_v<typename Names::next_name>) {
-        return counter + 1;
-    } else {
-        return get_size<typename Names::next_name, counter + 1>();
+constexpr ::std::uint32_t code_unit(Char const chr) noexcept {
+    return static_cast<::std::uint32_t>(static_cast<::std::make_unsigned_t<Char>>(chr));
+}
+
+/* append the code units of `str` to `chars`, instantiated once per String type rather than per name
+ */
+template<typename Str>
+constexpr void append(::std::uint32_t* const chars, ::std::size_t& next, Str const& str) noexcept {
+    for (auto const chr : str) {
+        chars[next++] = code_unit(chr);
+    }
+}
+
+template<is_names Names>
+struct of_;
+
+/* the names are inserted into a hash set, so checking N names costs O(N)
+ * expected work instead of the O(N^2) of comparing every pair
+ */
+template<auto... Keys>
+struct of_<names<Keys...>> {
+    static consteval bool check() noexcept {
+        constexpr auto count = sizeof...(Keys);
+
+        // the code units of every name, one after another
+        ::std::array<::std::uint32_t, (name_of<Keys>.size() + ...) + 1> chars{};
+        ::std::size_t offsets[count + 1]{};
+        ::std::size_t next{};
+        ::std::size_t index{};
+        ((offsets[index++] = next, append(chars.data(), next, name_of<Keys>)), ...);
+        offsets[count] = next;
+
+        // an open addressing table of the indexes of the names seen so far,
+        // only names with equal hashes are compared
+        constexpr auto slot_count = ::std::bit_ceil(count * 2);
+        ::std::array<::std::size_t, slot_count> slots{};
+        ::std::uint64_t hashes[count]{};
+        for (::std::size_t i{}; i < count; ++i) {
+            auto hash = ::std::uint64_t{0xcbf2'9ce4'8422'2325};
+            for (auto j = offsets[i]; j < offsets[i + 1]; ++j) {
+                hash = (hash ^ chars[j]) * 0x100'0000'01b3;
+            }
+            hashes[i] = hash;
+
+            auto slot = static_cast<::std::size_t>(hash) & (slot_count - 1);
+            for (; slots[slot] != 0; slot = (slot + 1) & (slot_count - 1)) {
+                auto const other = slots[slot] - 1;
+                if (hashes[other] == hash &&
+                    ::std::equal(chars.begin() + offsets[i], chars.begin() + offsets[i + 1],
+                                 chars.begin() + offsets[other], chars.begin() + offsets[other + 1])) {
+                    return false;
+                }
+            }
+            slots[slot] = i + 1;
+        }
+        return true;
     }
+
+    static constexpr bool value = check();
+};
+
+}  // namespace unique
+
+/* whether no name of `Names` appears twice, computed once per list of names
+ */
+template<is_names Names>
+constexpr bool unique_names = unique::of_<Names>::value;
+
+/* index of the name `Str` in `Names`
+ */
+template<string::String Str, is_names Names>
+[[nodiscard]]
+consteval ::std::size_t get_index() noexcept {
+    static_assert(unique_names<Names>, "ctb::namedtuple: duplicate names");
+    constexpr auto index = get_index_<Str, Names>::find();
+    static_assert(index < get_size<Names>(), "name not found");
+    return index;
 }
 
+/* element storage of NamedTuple
+ *
+ * every element is a public member of its own base, which keeps NamedTuple
+ * structural (unlike ::std::tuple) and makes accessing an element O(1) in
+ * template instantiations.
+ */
+template<::std::size_t I, typename T>
+struct leaf {
+    T value;
+};
+
+template<typename Indexes, typename... Args>
+struct storage;
+
+template<::std::size_t... I, typename... Args>
+struct storage<::std::index_sequence<I...>, Args...> : leaf<I, Args>... {};
+
+template<::std::size_t I, typename T>
+[[nodiscard]]
+constexpr T& leaf_get(leaf<I, T>& l) noexcept {
+    return l.value;
+}
+
+template<::std::size_t I, typename T>
+[[nodiscard]]
+constexpr T const& leaf_get(leaf<I, T> const& l) noexcept {
+    return l.value;
+}
+
+template<::std::size_t I, typename T>
+[[nodiscard]]
+constexpr T&& leaf_get(leaf<I, T>&& l) noexcept {
+    return static_cast<T&&>(l.value);
+}
+
+template<is_names To, is_names From>
+struct permutation_;
+
+/* for every name of `To`, its index in `From`
+ */
+template<auto... To, is_names From>
+struct permutation_<names<To...>, From> {
+    static constexpr ::std::size_t indexes[]{get_index_<name_of<To>, From>::find()...};
+    static constexpr bool valid = [] {
+        if (sizeof...(To) != get_size<From>()) {
+            return false;
+        }
+        for (auto const index : indexes) {
+            if (index == get_size<From>()) {
+                return false;
+            }
+        }
+        return true;
+    }();
+};
+
+/* whether `To` has the names of `From` in some order
+ */
+template<typename From, typename To>
+concept is_permutation = permutation_<To, From>::valid;
+
+template<is_names To, is_names From, typename = ::std::make_index_sequence<get_size<To>()>>
+struct reorder_;
+
+template<is_names To, is_names From, ::std::size_t... I>
+struct reorder_<To, From, ::std::index_sequence<I...>> {
+    using type = ::std::index_sequence<permutation_<To, From>::indexes[I]...>;
+};
+
+/* the elements of a namedtuple named `From` to pick, in order, to build one named `To`
+ */
+template<is_names To, is_names From>
+using reorder_t = typename reorder_<To, From>::type;
+
 }  // namespace ctb::namedtuple::details
 
 namespace ctb::namedtuple {
 
 template<string::String... Args>
-using names = details::names<Args...>;
+using names = details::names<details::key_of<Args>...>;
+
+template<details::is_names Names, typename... Args>
+    requires (details::get_size<Names>() == sizeof...(Args))
+struct NamedTuple;
+
+namespace details {
+
+template<typename>
+constexpr bool is_namedtuple_ = false;
+
+template<is_names Names, typename... Args>
+constexpr bool is_namedtuple_<NamedTuple<Names, Args...>> = true;
+
+}  // namespace details
+
+template<typename T>
+concept is_namedtuple = details::is_namedtuple_<::std::remove_cvref_t<T>>;
+
+namespace details {
+
+template<typename T, typename U>
+concept leaf_from = requires(U&& u) { leaf<0, T>{static_cast<U&&>(u)}; };
+
+template<typename Other, typename... Args, ::std::size_t... I>
+[[nodiscard]]
+consteval bool elements_from(::std::index_sequence<I...>) noexcept {
+    return (leaf_from<Args, decltype(leaf_get<I>(::std::declval<Other>().values))> && ...);
+}
+
+template<typename Other, typename... Args, ::std::size_t... I>
+[[nodiscard]]
+consteval bool elements_nothrow_from(::std::index_sequence<I...>) noexcept {
+    return (::std::is_nothrow_constructible_v<Args, decltype(leaf_get<I>(::std::declval<Other>().values))> && ...);
+}
+
+/* whether a namedtuple named `Names` of `Args...` can be built from `Other`,
+ * another namedtuple with the same names in any order
+ */
+template<typename Other, typename Names, typename... Args>
+concept reorders_from =
+    is_namedtuple<Other> && !::std::is_same_v<::std::remove_cvref_t<Other>, NamedTuple<Names, Args...>> &&
+    is_permutation<typename ::std::remove_cvref_t<Other>::names, Names> &&
+    elements_from<Other, Args...>(reorder_t<Names, typename ::std::remove_cvref_t<Other>::names>{});
+
+}  // namespace details
 
+/* A namedtuple is a structural type as long as all its elements are,
+ * so it can be used as a non-type template parameter:
+ *
+ * template<is_namedtuple auto Config>
+ * struct Worker {};
+ */
 template<details::is_names Names, typename... Args>
     requires (details::get_size<Names>() == sizeof...(Args))
 struct NamedTuple {
+    static_assert(details::unique_names<Names>, "ctb::namedtuple::NamedTuple: duplicate names");
+
     using names = Names;
-    ::std::tuple<Args...> tuple;
+    details::storage<::std::index_sequence_for<Args...>, Args...> values;
 
-    constexpr NamedTuple(Args&&... args) {
-        this->tuple = ::std::make_tuple(::std::forward<Args>(args)...);
-    }
+    // clang-format off
+    constexpr NamedTuple(Args const&... args) noexcept((::std::is_nothrow_copy_constructible_v<Args> && ...))
+        : values{{args}...}
+    {}
+
+    // the same as above when every element is an lvalue reference
+    constexpr NamedTuple(Args&&... args) noexcept((::std::is_nothrow_constructible_v<Args, Args&&> && ...))
+        requires (!(::std::is_lvalue_reference_v<Args> && ...))
+        : values{{::std::forward<Args>(args)}...}
+    {}
+
+    /* convert from a namedtuple with the same names, maybe in another order,
+     * the order is resolved at compile time so every element is copied or moved once
+     */
+    template<details::reorders_from<Names, Args...> Other>
+    constexpr NamedTuple(Other&& other) noexcept(
+        details::elements_nothrow_from<Other, Args...>(
+            details::reorder_t<Names, typename ::std::remove_cvref_t<Other>::names>{}))
+        : NamedTuple{details::reorder_t<Names, typename ::std::remove_cvref_t<Other>::names>{},
+                     ::std::forward<Other>(other)}
+    {}
+
+    // clang-format on
+
+private:
+    // clang-format off
+    template<::std::size_t... I, typename Other>
+    constexpr NamedTuple(::std::index_sequence<I...>, Other&& other) noexcept(
+        details::elements_nothrow_from<Other, Args...>(::std::index_sequence<I...>{}))
+        : values{{details::leaf_get<I>(::std::forward<Other>(other).values)}...}
+    {}
+
+    // clang-format on
 };
 
 template<string::String... Str, typename... Args>
     requires (sizeof...(Str) == sizeof...(Args))
 [[nodiscard]]
-constexpr auto make_namedtuple(Args&&... args) noexcept {
+constexpr auto make_namedtuple(Args&&... args) noexcept(
+    (::std::is_nothrow_constructible_v<::std::decay_t<Args>, Args&&> && ...)) {
     return NamedTuple<names<Str...>, ::std::decay_t<Args>...>{::std::forward<Args>(args)...};
 }
 
-/* get namedtuple element by name
+/* a namedtuple of lvalue references to `args`, nothing is copied
+ *
+ * Usage: log(named_tie<"id", "latency">(id, latency))
+ */
+template<string::String... Str, typename... Args>
+    requires (sizeof...(Str) == sizeof...(Args))
+[[nodiscard]]
+constexpr auto named_tie(Args&... args) noexcept {
+    return NamedTuple<names<Str...>, Args&...>{args...};
+}
+
+/* a namedtuple of references to `args`, rvalues are kept as rvalue references,
+ * so it must not outlive the full expression it is made in if any of them is a temporary
  *
- * Usage: get<"name">(nt)
+ * Usage: serialize(forward_as_namedtuple<"id", "name">(id, ::std::move(name)))
  */
-template<string::String str, ::std::size_t index = 0, details::is_names Names, typename... Args>
+template<string::String... Str, typename... Args>
+    requires (sizeof...(Str) == sizeof...(Args))
 [[nodiscard]]
-constexpr auto get(NamedTuple<Names, Args...> nt) noexcept {
-    static_assert(index < details::get_size<Names>(), "index out of range");
-    if constexpr (details::get_name<index, Names>() == str) {
-        return ::std::get<index>(nt.tuple);
+constexpr auto forward_as_namedtuple(Args&&... args) noexcept {
+    return NamedTuple<names<Str...>, Args&&...>{::std::forward<Args>(args)...};
+}
+
+/* a field of a schema, with an optional compile-time default value
+ *
+ * Usage: field<"timeout", int, 30>, field<"host", char const*>
+ */
+template<string::String Name, typename T, auto... Default>
+    requires (sizeof...(Default) <= 1)
+struct field {
+    static constexpr auto name{Name};
+    using type = T;
+    static constexpr bool has_default{sizeof...(Default) == 1};
+
+    [[nodiscard]]
+    static constexpr T default_value() noexcept
+        requires (has_default)
+    {
+        return T{Default...};
+    }
+};
+
+namespace details {
+
+template<typename>
+constexpr bool is_field_ = false;
+
+template<string::String Name, typename T, auto... Default>
+constexpr bool is_field_<field<Name, T, Default...>> = true;
+
+template<typename T>
+concept is_field = is_field_<T>;
+
+}  // namespace details
+
+/* a list of fields, `schema<...>::type` is the namedtuple it describes
+ */
+template<details::is_field First, details::is_field... Rest>
+struct schema {
+    using names = namedtuple::names<First::name, Rest::name...>;
+    using type = NamedTuple<names, typename First::type, typename Rest::type...>;
+};
+
+namespace details {
+
+template<typename>
+constexpr bool is_schema_ = false;
+
+template<is_field... Fields>
+constexpr bool is_schema_<schema<Fields...>> = true;
+
+template<typename T>
+concept is_schema = is_schema_<T>;
+
+template<string::String Str, string::String... Given>
+[[nodiscard]]
+consteval ::std::size_t find_given() noexcept {
+    if constexpr (sizeof...(Given) == 0) {
+        return 0;
     } else {
-        return get<str, index + 1>(nt);
+        return get_index_<Str, names<key_of<Given>...>>::find();
+    }
+}
+
+/* the value of `Field`: the given argument of the same name, or its default
+ */
+template<is_field Field, string::String... Given, typename... Args>
+[[nodiscard]]
+constexpr auto pick_field(Args&&... args) noexcept -> decltype(auto) {
+    constexpr auto index = find_given<Field::name, Given...>();
+    if constexpr (index < sizeof...(Given)) {
+        return ::std::get<index>(::std::forward_as_tuple(::std::forward<Args>(args)...));
+    } else {
+        static_assert(Field::has_default, "ctb::namedtuple::make_namedtuple: missing a field without default");
+        return Field::default_value();
+    }
+}
+
+template<is_names Names, string::String... Given>
+[[nodiscard]]
+consteval bool all_known() noexcept {
+    return ((get_index_<Given, Names>::find() < get_size<Names>()) && ...);
+}
+
+}  // namespace details
+
+/* make a namedtuple of `Schema` from a subset of its fields,
+ * the others are filled with their compile-time defaults
+ *
+ * Usage:
+ *   using options = schema<field<"timeout", int, 30>, field<"retries", int, 3>>;
+ *   auto opts = make_namedtuple<options, "retries">(5);  // timeout == 30
+ */
+template<details::is_schema Schema, string::String... Str, typename... Args>
+    requires (sizeof...(Str) == sizeof...(Args))
+[[nodiscard]]
+constexpr auto make_namedtuple(Args&&... args) noexcept {
+    static_assert(details::all_known<typename Schema::names, Str...>(),
+                  "ctb::namedtuple::make_namedtuple: name not in schema");
+    if constexpr (sizeof...(Str) != 0) {
+        static_assert(details::unique_names<names<Str...>>, "ctb::namedtuple::make_namedtuple: name given twice");
     }
+    return []<details::is_field... Fields>(schema<Fields...>*, auto&&... args_) {
+        return typename Schema::type{
+            details::pick_field<Fields, Str...>(::std::forward<decltype(args_)>(args_)...)...};
+    }(static_cast<Schema*>(nullptr), ::std::forward<Args>(args)...);
 }
 
 /* get namedtuple element by index
  *
  * Usage: get<1>(nt)
  */
-template<::std::size_t N, details::is_names Names, typename... Args>
+template<::std::size_t N, is_namedtuple NT>
+[[nodiscard]]
+constexpr auto get(NT&& nt) noexcept -> decltype(auto) {
+    static_assert(N < details::get_size<typename ::std::remove_cvref_t<NT>::names>(), "index out of range");
+    return details::leaf_get<N>(::std::forward<NT>(nt).values);
+}
+
+namespace details::path {
+
+/* position of the first '.' in `Str`, or its size
+ */
+template<string::String Str>
+[[nodiscard]]
+consteval ::std::size_t first_dot() noexcept {
+    for (::std::size_t i{}; i < Str.size(); ++i) {
+        if (Str.str[i] == '.') {
+            return i;
+        }
+    }
+    return Str.size();
+}
+
+/* whether `Str` is a path into a nested namedtuple rather than a name of `Names`
+ */
+template<string::String Str, is_names Names>
+constexpr bool is_path = first_dot<Str>() != Str.size() && get_index_<Str, Names>::find() == get_size<Names>();
+
+}  // namespace details::path
+
+/* get namedtuple element by name, or by a path of names through nested namedtuples,
+ * a name that contains '.' itself is matched before it is split
+ *
+ * Usage: get<"name">(nt), get<"request.headers.host">(nt)
+ */
+template<string::String str, is_namedtuple NT>
+[[nodiscard]]
+constexpr auto get(NT&& nt) noexcept -> decltype(auto) {
+    using names_ = typename ::std::remove_cvref_t<NT>::names;
+    if constexpr (details::path::is_path<str, names_>) {
+        constexpr auto dot = details::path::first_dot<str>();
+        auto&& head = get<str.template substr<0, dot>()>(::std::forward<NT>(nt));
+        static_assert(is_namedtuple<decltype(head)>, "ctb::namedtuple::get: path goes through a non-namedtuple");
+        return get<str.template substr<dot + 1>()>(::std::forward<decltype(head)>(head));
+    } else {
+        return get<details::get_index<str, names_>()>(::std::forward<NT>(nt));
+    }
+}
+
+/* the elements of `nt` in the order of `Names`, which must have the same names as `nt`
+ *
+ * Usage: reorder_as<names<"c", "a", "b">>(make_namedtuple<"a", "b", "c">(1, 2, 3))  // (3, 1, 2)
+ */
+template<details::is_names Names, is_namedtuple NT>
+[[nodiscard]]
+constexpr auto reorder_as(NT&& nt) noexcept {
+    using from = typename ::std::remove_cvref_t<NT>::names;
+    static_assert(details::is_permutation<from, Names>, "ctb::namedtuple::reorder_as: names differ");
+    return [&]<::std::size_t... I>(::std::index_sequence<I...>) {
+        return NamedTuple<Names, ::std::tuple_element_t<I, ::std::remove_cvref_t<NT>>...>{::std::forward<NT>(nt)};
+    }(details::reorder_t<Names, from>{});
+}
+
+namespace details::flat {
+
+/* a leaf of a nested namedtuple, reached through the elements `Path...`
+ */
+template<string::String Name, typename T, ::std::size_t... Path>
+struct leaf_ {
+    static constexpr auto name{Name};
+    using type = T;
+};
+
+template<typename... Leaves>
+struct list {};
+
+template<typename... Lists>
+struct join_;
+
+template<typename... Leaves>
+struct join_<list<Leaves...>> {
+    using type = list<Leaves...>;
+};
+
+template<typename... L, typename... R, typename... Rest>
+struct join_<list<L...>, list<R...>, Rest...> {
+    using type = typename join_<list<L..., R...>, Rest...>::type;
+};
+
+/* `Leaf` of the namedtuple that is element I, named `Prefix`, of its parent
+ */
+template<string::String Prefix, ::std::size_t I, typename Leaf>
+struct prefix_;
+
+template<string::String Prefix, ::std::size_t I, string::String Name, typename T, ::std::size_t... Path>
+struct prefix_<Prefix, I, leaf_<Name, T, Path...>> {
+    static constexpr auto path{
+        string::concat(string::code_cvt<char>(Prefix), string::String{"."}, string::code_cvt<char>(Name))};
+    using type = leaf_<path, T, I, Path...>;
+};
+
+template<string::String Prefix, ::std::size_t I, typename List>
+struct prefix_all_;
+
+template<string::String Prefix, ::std::size_t I, typename... Leaves>
+struct prefix_all_<Prefix, I, list<Leaves...>> {
+    using type = list<typename prefix_<Prefix, I, Leaves>::type...>;
+};
+
+template<::std::size_t I, auto Key, typename T>
+struct field_ {
+    using type = list<leaf_<name_of<Key>, T, I>>;
+};
+
+template<typename NT, typename Indexes = ::std::make_index_sequence<::std::tuple_size_v<NT>>>
+struct of_;
+
+template<::std::size_t I, auto Key, is_namedtuple T>
+struct field_<I, Key, T> {
+    using type = typename prefix_all_<name_of<Key>, I, typename of_<T>::type>::type;
+};
+
+/* the leaves of a namedtuple, nested namedtuples are replaced by their leaves
+ */
+template<auto... Keys, typename... Args, ::std::size_t... I>
+struct of_<NamedTuple<names<Keys...>, Args...>, ::std::index_sequence<I...>> {
+    using type = typename join_<typename field_<I, Keys, Args>::type...>::type;
+};
+
+template<typename List>
+struct to_namedtuple_;
+
+template<typename... Leaves>
+struct to_namedtuple_<list<Leaves...>> {
+    using type = NamedTuple<names<key_of<Leaves::name>...>, typename Leaves::type...>;
+};
+
+template<::std::size_t First, ::std::size_t... Rest, typename NT>
+[[nodiscard]]
+constexpr auto const& get_at(NT const& nt) noexcept {
+    if constexpr (sizeof...(Rest) == 0) {
+        return get<First>(nt);
+    } else {
+        return get_at<Rest...>(get<First>(nt));
+    }
+}
+
+template<string::String Name, typename T, ::std::size_t... Path, typename NT>
+[[nodiscard]]
+constexpr T const& get_leaf(leaf_<Name, T, Path...>*, NT const& nt) noexcept {
+    return get_at<Path...>(nt);
+}
+
+}  // namespace details::flat
+
+/* the namedtuple with the leaves of `NT` as its elements,
+ * a leaf of a nested namedtuple is named by its path, like "request.headers.host"
+ */
+template<is_namedtuple NT>
+using flattened_t = typename details::flat::to_namedtuple_<
+    typename details::flat::of_<::std::remove_cvref_t<NT>>::type>::type;
+
+/* shred a nested namedtuple into its leaves
+ *
+ * Usage: get<"request.headers.host">(flatten(event))
+ */
+template<is_namedtuple NT>
+[[nodiscard]]
+constexpr auto flatten(NT const& nt) noexcept {
+    return [&]<typename... Leaves>(details::flat::list<Leaves...>*) {
+        return flattened_t<NT>{details::flat::get_leaf(static_cast<Leaves*>(nullptr), nt)...};
+    }(static_cast<typename details::flat::of_<NT>::type*>(nullptr));
+}
+
+namespace details::layout {
+
+template<typename>
+constexpr bool is_laid_out_ = false;
+
+/* only namedtuples of objects have a layout: a reference element, as made by `named_tie`,
+ * has no size, alignment or offset of its own
+ */
+template<is_names Names, typename... Args>
+constexpr bool is_laid_out_<NamedTuple<Names, Args...>> = !(::std::is_reference_v<Args> || ...);
+
+template<typename NT>
+concept is_laid_out = is_laid_out_<::std::remove_cv_t<NT>>;
+
+template<typename>
+struct of_;
+
+/* elements are laid out in order, each aligned to its own alignment,
+ * as every mainstream ABI places non-virtual bases in declaration order
+ */
+template<is_names Names, typename... Args>
+    requires (is_laid_out<NamedTuple<Names, Args...>>)
+struct of_<NamedTuple<Names, Args...>> {
+    // offsets of the elements, followed by the end of the last element
+    static constexpr auto offsets = [] {
+        ::std::array<::std::size_t, sizeof...(Args) + 1> res{};
+        ::std::size_t end{}, i{};
+        ((end = (end + alignof(Args) - 1) / alignof(Args) * alignof(Args), res[i++] = end, end += sizeof(Args)), ...);
+        res[i] = end;
+        return res;
+    }();
+
+    static constexpr auto align = alignof(NamedTuple<Names, Args...>);
+    static_assert(sizeof(NamedTuple<Names, Args...>) == (offsets.back() + align - 1) / align * align,
+                  "ctb::namedtuple: unexpected layout");
+};
+
+}  // namespace details::layout
+
+/* byte offset of element I in a namedtuple
+ */
+template<::std::size_t I, is_namedtuple NT>
+    requires (details::layout::is_laid_out<NT>)
+[[nodiscard]]
+consteval ::std::size_t offset_of() noexcept {
+    return details::layout::of_<::std::remove_cv_t<NT>>::offsets[I];
+}
+
+namespace details::fingerprint {
+
+constexpr ::std::uint64_t fnv_offset{14695981039346656037ull};
+constexpr ::std::uint64_t fnv_prime{1099511628211ull};
+
+[[nodiscard]]
+constexpr ::std::uint64_t mix(::std::uint64_t hash, ::std::uint64_t value) noexcept {
+    for (int i{}; i < 8; ++i, value >>= 8) {
+        hash ^= value & 0xff;
+        hash *= fnv_prime;
+    }
+    return hash;
+}
+
+enum class kind : ::std::uint64_t {
+    other,
+    boolean,
+    character,
+    signed_integer,
+    unsigned_integer,
+    floating_point,
+    enumeration,
+    pointer,
+    namedtuple,
+};
+
+template<typename T>
+[[nodiscard]]
+consteval kind kind_of() noexcept {
+    if constexpr (::std::is_same_v<T, bool>) {
+        return kind::boolean;
+    } else if constexpr (string::is_char<T>) {
+        return kind::character;
+    } else if constexpr (::std::is_integral_v<T>) {
+        return ::std::is_signed_v<T> ? kind::signed_integer : kind::unsigned_integer;
+    } else if constexpr (::std::is_floating_point_v<T>) {
+        return kind::floating_point;
+    } else if constexpr (::std::is_enum_v<T>) {
+        return kind::enumeration;
+    } else if constexpr (::std::is_pointer_v<T>) {
+        return kind::pointer;
+    } else if constexpr (is_namedtuple<T>) {
+        return kind::namedtuple;
+    } else {
+        return kind::other;
+    }
+}
+
+template<typename NT>
+struct of_;
+
+/* a type is summarized by its kind, size and alignment,
+ * a nested namedtuple by its own fingerprint
+ */
+template<typename T>
+[[nodiscard]]
+constexpr ::std::uint64_t type_hash(::std::uint64_t hash) noexcept {
+    hash = mix(hash, static_cast<::std::uint64_t>(kind_of<::std::remove_cv_t<T>>()));
+    if constexpr (kind_of<::std::remove_cv_t<T>>() == kind::namedtuple) {
+        hash = mix(hash, of_<::std::remove_cv_t<T>>::value);
+    }
+    return mix(mix(hash, sizeof(T)), alignof(T));
+}
+
+template<string::String Str>
+[[nodiscard]]
+constexpr ::std::uint64_t name_hash(::std::uint64_t hash) noexcept {
+    for (auto const chr : Str) {
+        if (chr == 0) {
+            break;
+        }
+        hash ^= static_cast<::std::uint64_t>(static_cast<::std::make_unsigned_t<decltype(chr)>>(chr));
+        hash *= fnv_prime;
+    }
+    // names are separated by a byte that no code unit of a name can be
+    hash ^= 0xff;
+    return hash * fnv_prime;
+}
+
+template<auto... Keys, typename... Args>
+struct of_<NamedTuple<names<Keys...>, Args...>> {
+    static constexpr ::std::uint64_t value = [] {
+        auto hash = fnv_offset;
+        ((hash = type_hash<Args>(name_hash<name_of<Keys>>(hash))), ...);
+        return hash;
+    }();
+};
+
+}  // namespace details::fingerprint
+
+/* a 64-bit hash of the names and field types (kind, size and alignment) of a namedtuple,
+ * to check that data written by one binary is read with the same schema
+ *
+ * Usage: fingerprint<decltype(nt)>()
+ */
+template<is_namedtuple NT>
 [[nodiscard]]
-constexpr auto get(NamedTuple<Names, Args...> nt) noexcept {
-    return ::std::get<N>(nt.tuple);
+consteval ::std::uint64_t fingerprint() noexcept {
+    return details::fingerprint::of_<::std::remove_cvref_t<NT>>::value;
 }
 
 }  // namespace ctb::namedtuple
@@ -121,7 +900,26 @@ struct tuple_size<::ctb::namedtuple::NamedTuple<Names, Args...>>
 
 template<::std::size_t N, ::ctb::namedtuple::details::is_names Names, typename... Args>
 struct tuple_element<N, ::ctb::namedtuple::NamedTuple<Names, Args...>> {
-    using type = decltype(::std::get<N>(::std::declval<::ctb::namedtuple::NamedTuple<Names, Args...>>().tuple));
+    using type = ::std::tuple_element_t<N, ::std::tuple<Args...>>;
+};
+
+/* namedtuples with the same names have a common reference, so a namedtuple of references
+ * can be the reference type of an iterator whose value type is a namedtuple of values
+ */
+template<::ctb::namedtuple::details::is_names Names, typename... T, typename... U, template<typename> typename TQual,
+         template<typename> typename UQual>
+    requires requires {
+        typename ::ctb::namedtuple::NamedTuple<Names, ::std::common_reference_t<TQual<T>, UQual<U>>...>;
+    }
+struct basic_common_reference<::ctb::namedtuple::NamedTuple<Names, T...>, ::ctb::namedtuple::NamedTuple<Names, U...>,
+                              TQual, UQual> {
+    using type = ::ctb::namedtuple::NamedTuple<Names, ::std::common_reference_t<TQual<T>, UQual<U>>...>;
+};
+
+template<::ctb::namedtuple::details::is_names Names, typename... T, typename... U>
+    requires requires { typename ::ctb::namedtuple::NamedTuple<Names, ::std::common_type_t<T, U>...>; }
+struct common_type<::ctb::namedtuple::NamedTuple<Names, T...>, ::ctb::namedtuple::NamedTuple<Names, U...>> {
+    using type = ::ctb::namedtuple::NamedTuple<Names, ::std::common_type_t<T, U>...>;
 };
 
 }  // namespace std
@@ -0,0 +1,164 @@
+#pragma once
+
+#if !__cpp_concepts >= 201907L
+    #error "perfect_hash requires at least c++20"
+#endif
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+#include "namedtuple.hh"
+
+namespace ctb::namedtuple::details::perfect_hash {
+
+template<string::is_char Char>
+[[nodiscard]]
+constexpr ::std::uint32_t code_unit(Char const chr) noexcept {
+    return static_cast<::std::uint32_t>(static_cast<::std::make_unsigned_t<Char>>(chr));
+}
+
+[[nodiscard]]
+constexpr ::std::uint32_t code_unit(::std::uint32_t const chr) noexcept {
+    return chr;
+}
+
+/* FNV-1a over code units, so a name hashes the same whichever char type spells it
+ */
+template<typename Iter>
+[[nodiscard]]
+constexpr ::std::uint32_t fnv1a(Iter first, Iter const last, ::std::uint32_t const seed) noexcept {
+    auto hash = ::std::uint32_t{2166136261u} ^ seed;
+    for (; first != last; ++first) {
+        hash ^= code_unit(*first);
+        hash *= ::std::uint32_t{16777619u};
+    }
+    return hash;
+}
+
+template<string::String Str>
+[[nodiscard]]
+consteval ::std::size_t name_length() noexcept {
+    ::std::size_t len{};
+    while (len < Str.size() && Str.str[len] != 0) {
+        ++len;
+    }
+    return len;
+}
+
+template<is_names Names>
+struct name_table;
+
+/* All names of a schema flattened into one array of code units, plus a
+ * collision-free slot table found by searching for a seed at compile time.
+ */
+template<auto... Keys>
+struct name_table<names<Keys...>> {
+    static constexpr ::std::size_t size{sizeof...(Keys)};
+    static constexpr ::std::size_t lengths[]{name_length<name_of<Keys>>()...};
+
+    static constexpr auto offsets = [] {
+        ::std::array<::std::size_t, size + 1> res{};
+        for (::std::size_t i{}; i < size; ++i) {
+            res[i + 1] = res[i] + lengths[i];
+        }
+        return res;
+    }();
+
+    static constexpr auto chars = [] {
+        ::std::array<::std::uint32_t, offsets[size] + 1> res{};
+        ::std::size_t index{}, i{};
+        (
+            [&] {
+                for (::std::size_t j{}; j < lengths[i]; ++j) {
+                    res[index++] = code_unit(name_of<Keys>.str[j]);
+                }
+                ++i;
+            }(),
+            ...);
+        return res;
+    }();
+
+    [[nodiscard]]
+    static constexpr ::std::uint32_t hash_of(::std::size_t const i, ::std::uint32_t const seed) noexcept {
+        return fnv1a(chars.data() + offsets[i], chars.data() + offsets[i + 1], seed);
+    }
+
+    struct params {
+        ::std::uint32_t seed;
+        ::std::size_t slot_count;
+    };
+
+    static constexpr auto found = [] {
+        if (!unique_names<names<Keys...>>) {
+            // `find_name` rejects these, give up instead of searching forever
+            return params{0, ::std::bit_ceil(size)};
+        }
+        for (auto slot_count = ::std::bit_ceil(size);; slot_count *= 2) {
+            for (::std::uint32_t seed{}; seed < 256; ++seed) {
+                auto* used = new bool[slot_count]{};
+                auto ok = true;
+                for (::std::size_t i{}; i < size && ok; ++i) {
+                    auto& slot = used[hash_of(i, seed) & (slot_count - 1)];
+                    ok = !slot;
+                    slot = true;
+                }
+                delete[] used;
+                if (ok) {
+                    return params{seed, slot_count};
+                }
+            }
+        }
+    }();
+
+    static constexpr auto slots = [] {
+        ::std::array<::std::size_t, found.slot_count> res{};
+        res.fill(size);
+        for (::std::size_t i{}; i < size; ++i) {
+            res[hash_of(i, found.seed) & (found.slot_count - 1)] = i;
+        }
+        return res;
+    }();
+};
+
+}  // namespace ctb::namedtuple::details::perfect_hash
+
+namespace ctb::namedtuple {
+
+/* look up the index of a name known only at runtime, with one hash and
+ * at most one string comparison
+ * returns the count of names if `name` is not one of them
+ *
+ * Usage: find_name<names<"a", "b">>("b") == 1
+ */
+template<details::is_names Names, string::is_char Char>
+[[nodiscard]]
+constexpr ::std::size_t find_name(::std::basic_string_view<Char> const name) noexcept {
+    // with duplicate names no seed separates them, and the search would never end
+    static_assert(details::unique_names<Names>, "ctb::namedtuple::find_name: duplicate names");
+    using table = details::perfect_hash::name_table<Names>;
+
+    auto const hash = details::perfect_hash::fnv1a(name.begin(), name.end(), table::found.seed);
+    auto const index = table::slots[hash & (table::found.slot_count - 1)];
+    if (index == table::size || table::lengths[index] != name.size()) {
+        return table::size;
+    }
+    auto const* expected = table::chars.data() + table::offsets[index];
+    for (::std::size_t i{}; i < name.size(); ++i) {
+        if (expected[i] != details::perfect_hash::code_unit(name[i])) {
+            return table::size;
+        }
+    }
+    return index;
+}
+
+template<details::is_names Names, string::is_char Char, ::std::size_t N>
+[[nodiscard]]
+constexpr ::std::size_t find_name(Char const (&name)[N]) noexcept {
+    return find_name<Names>(::std::basic_string_view<Char>{name});
+}
+
+}  // namespace ctb::namedtuple
@@ -0,0 +1,207 @@
+#pragma once
+
+#if !__cpp_concepts >= 201907L
+    #error "rcu requires at least c++20"
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "namedtuple.hh"
+
+namespace ctb::namedtuple::details::rcu {
+
+/* the epoch a reader is reading in, 0 if it is not reading
+ * every slot has its own cache line, so readers never share one
+ */
+struct alignas(64) slot {
+    ::std::atomic<::std::uint64_t> epoch{};
+    ::std::atomic<bool> claimed{};
+};
+
+template<typename NT>
+struct retired {
+    NT const* value;
+    ::std::uint64_t epoch;
+};
+
+}  // namespace ctb::namedtuple::details::rcu
+
+namespace ctb::namedtuple {
+
+/* an immutable namedtuple that can be replaced while it is being read
+ *
+ * readers announce the current epoch in their own slot and read the current
+ * snapshot through a plain pointer, without any read-modify-write.
+ * writers publish a new snapshot, and a replaced snapshot is deleted once
+ * every reader has moved past the epoch it was replaced in.
+ *
+ * Usage:
+ *   auto config = RcuCell<config_t>{initial};
+ *   auto reader = config.reader();            // once per reading thread
+ *   auto snapshot = reader->read();           // per request
+ *   get<"threads">(*snapshot);
+ *   config.publish(new_config);               // any thread
+ */
+template<is_namedtuple NT, ::std::size_t MaxReaders = 64>
+struct RcuCell {
+    /* a read-side critical section, the snapshot stays alive until it is destroyed
+     */
+    struct ReadGuard {
+        explicit ReadGuard(details::rcu::slot* slot, NT const* value) noexcept
+            : slot_{slot}, value_{value} {
+        }
+
+        ReadGuard(ReadGuard const&) = delete;
+        ReadGuard& operator=(ReadGuard const&) = delete;
+
+        ~ReadGuard() noexcept {
+            this->slot_->epoch.store(0, ::std::memory_order_release);
+        }
+
+        [[nodiscard]]
+        NT const& operator*() const noexcept {
+            return *this->value_;
+        }
+
+        [[nodiscard]]
+        NT const* operator->() const noexcept {
+            return this->value_;
+        }
+
+    private:
+        details::rcu::slot* slot_;
+        NT const* value_;
+    };
+
+    /* a reader owns one slot of the cell, it must be used by one thread at a time
+     */
+    struct Reader {
+        explicit Reader(RcuCell& cell, details::rcu::slot& slot) noexcept
+            : cell_{&cell}, slot_{&slot} {
+        }
+
+        Reader(Reader&& other) noexcept
+            : cell_{other.cell_}, slot_{::std::exchange(other.slot_, nullptr)} {
+        }
+
+        Reader(Reader const&) = delete;
+        Reader& operator=(Reader const&) = delete;
+
+        ~Reader() noexcept {
+            if (this->slot_ != nullptr) {
+                this->slot_->claimed.store(false, ::std::memory_order_release);
+            }
+        }
+
+        [[nodiscard]]
+        ReadGuard read() const noexcept {
+            assert(this->slot_->epoch.load(::std::memory_order_relaxed) == 0);  // reads can't nest
+            // the three accesses are seq_cst, so they are ordered with the exchange of `current_` and the
+            // increment of `epoch_` in `publish`: an epoch that is already incremented means the pointer
+            // loaded after it is the new snapshot, and the announcement is visible to `reclaim_locked`
+            // before the pointer is loaded
+            auto const epoch = this->cell_->epoch_.load(::std::memory_order_seq_cst);
+            this->slot_->epoch.store(epoch, ::std::memory_order_seq_cst);
+            return ReadGuard{this->slot_, this->cell_->current_.load(::std::memory_order_seq_cst)};
+        }
+
+    private:
+        RcuCell* cell_;
+        details::rcu::slot* slot_;
+    };
+
+    explicit RcuCell(NT const& initial)
+        : current_{new NT(initial)} {
+    }
+
+    RcuCell(RcuCell const&) = delete;
+    RcuCell& operator=(RcuCell const&) = delete;
+
+    ~RcuCell() noexcept {
+        delete this->current_.load(::std::memory_order_relaxed);
+        for (auto const& r : this->retired_) {
+            delete r.value;
+        }
+    }
+
+    /* claim a reader slot, nullopt if all `MaxReaders` slots are taken
+     */
+    [[nodiscard]]
+    ::std::optional<Reader> reader() noexcept {
+        for (auto& slot : this->slots_) {
+            auto expected = false;
+            if (slot.claimed.compare_exchange_strong(expected, true, ::std::memory_order_acquire)) {
+                return Reader{*this, slot};
+            }
+        }
+        return ::std::nullopt;
+    }
+
+    /* replace the snapshot, and delete the replaced snapshots no reader can see anymore
+     */
+    void publish(NT const& value) {
+        auto* const next = new NT(value);
+        auto const lock = ::std::lock_guard{this->writer_mutex_};
+        try {
+            // the replaced snapshot must have a place in `retired_` before it is replaced
+            if (this->retired_.size() == this->retired_.capacity()) {
+                this->retired_.reserve(::std::max<::std::size_t>(2 * this->retired_.capacity(), 8));
+            }
+        } catch (...) {
+            delete next;
+            throw;
+        }
+        auto const* const prev = this->current_.exchange(next, ::std::memory_order_seq_cst);
+        this->retired_.push_back({prev, this->epoch_.fetch_add(1, ::std::memory_order_seq_cst)});
+        this->reclaim_locked();
+    }
+
+    /* delete the replaced snapshots no reader can see anymore,
+     * returns how many are still waiting for readers
+     */
+    ::std::size_t reclaim() {
+        auto const lock = ::std::lock_guard{this->writer_mutex_};
+        this->reclaim_locked();
+        return this->retired_.size();
+    }
+
+private:
+    // epochs start at 1, a slot holding 0 is not reading
+    ::std::atomic<::std::uint64_t> epoch_{1};
+    ::std::atomic<NT const*> current_;
+    ::std::array<details::rcu::slot, MaxReaders> slots_{};
+
+    ::std::mutex writer_mutex_;
+    ::std::vector<details::rcu::retired<NT>> retired_;
+
+    /* a snapshot replaced in epoch `e` was only visible to readers that
+     * announced `e` or earlier, so it can be deleted once none of them is left
+     */
+    void reclaim_locked() noexcept {
+        auto oldest = this->epoch_.load(::std::memory_order_seq_cst);
+        for (auto const& slot : this->slots_) {
+            auto const epoch = slot.epoch.load(::std::memory_order_seq_cst);
+            if (epoch != 0 && epoch < oldest) {
+                oldest = epoch;
+            }
+        }
+        ::std::erase_if(this->retired_, [oldest](details::rcu::retired<NT> const& r) noexcept {
+            if (r.epoch < oldest) {
+                delete r.value;
+                return true;
+            }
+            return false;
+        });
+    }
+};
+
+}  // namespace ctb::namedtuple
@@ -0,0 +1,331 @@
+#pragma once
+
+#if !__cpp_concepts >= 201907L
+    #error "record_log requires at least c++20"
+#endif
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+    #include <io.h>
+#else
+    #include <unistd.h>
+#endif
+
+#include "namedtuple.hh"
+
+namespace ctb::namedtuple::details::record_log {
+
+constexpr auto crc_table = [] {
+    ::std::array<::std::uint32_t, 256> res{};
+    for (::std::uint32_t i{}; i < res.size(); ++i) {
+        auto crc = i;
+        for (int bit{}; bit < 8; ++bit) {
+            crc = crc & 1 ? (crc >> 1) ^ 0xedb88320u : crc >> 1;
+        }
+        res[i] = crc;
+    }
+    return res;
+}();
+
+/* CRC-32 (IEEE 802.3)
+ */
+[[nodiscard]]
+constexpr ::std::uint32_t crc32(::std::byte const* data, ::std::size_t const size) noexcept {
+    auto crc = ~::std::uint32_t{};
+    for (::std::size_t i{}; i < size; ++i) {
+        crc = crc_table[(crc ^ static_cast<::std::uint32_t>(data[i])) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+/* every record is framed as header + the bytes of the record,
+ * all in native byte order
+ */
+struct frame_header {
+    ::std::uint32_t length;
+    ::std::uint32_t crc;
+    ::std::uint64_t fingerprint;
+};
+
+static_assert(sizeof(frame_header) == 16);
+
+template<typename T, ::std::size_t N>
+constexpr void mark_fields(::std::array<bool, N>& used, ::std::size_t const base) noexcept {
+    if constexpr (is_namedtuple<T>) {
+        [&]<::std::size_t... I>(::std::index_sequence<I...>) {
+            (mark_fields<::std::remove_cv_t<::std::tuple_element_t<I, T>>>(used, base + offset_of<I, T>()), ...);
+        }(::std::make_index_sequence<::std::tuple_size_v<T>>{});
+    } else {
+        for (::std::size_t i{}; i < sizeof(T); ++i) {
+            used[base + i] = true;
+        }
+    }
+}
+
+/* whether the only padding of `T` lies between namedtuple fields, where `field_bytes` finds it.
+ * a struct or a long double field has padding of its own, which would be written as is.
+ */
+template<typename T>
+[[nodiscard]]
+consteval bool padded_between_fields() noexcept {
+    if constexpr (is_namedtuple<T>) {
+        return [&]<::std::size_t... I>(::std::index_sequence<I...>) {
+            return (padded_between_fields<::std::remove_cv_t<::std::tuple_element_t<I, T>>>() && ...);
+        }(::std::make_index_sequence<::std::tuple_size_v<T>>{});
+    } else if constexpr (::std::is_array_v<T>) {
+        return padded_between_fields<::std::remove_cv_t<::std::remove_extent_t<T>>>();
+    } else if constexpr (::std::is_scalar_v<T>) {
+        return !::std::is_same_v<T, long double>;
+    } else {
+        return ::std::has_unique_object_representations_v<T>;
+    }
+}
+
+/* a namedtuple whose records are written byte for byte, with every padding byte zeroed
+ */
+template<typename NT>
+concept loggable = is_namedtuple<NT> && ::std::is_trivially_copyable_v<NT> && padded_between_fields<NT>();
+
+/* which bytes of `NT` belong to a field, down into nested namedtuples,
+ * the others are padding and are written as zeros
+ */
+template<typename NT>
+constexpr auto field_bytes = [] {
+    ::std::array<bool, sizeof(NT)> res{};
+    mark_fields<NT>(res, 0);
+    return res;
+}();
+
+[[nodiscard]]
+inline bool sync(::std::FILE* file) noexcept {
+#if defined(_WIN32)
+    return ::_commit(::_fileno(file)) == 0;
+#else
+    return ::fsync(::fileno(file)) == 0;
+#endif
+}
+
+[[nodiscard]]
+inline bool seek(::std::FILE* file, ::std::uint64_t const offset) noexcept {
+#if defined(_WIN32)
+    return ::_fseeki64(file, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+    return ::fseeko(file, static_cast<::off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+}  // namespace ctb::namedtuple::details::record_log
+
+namespace ctb::namedtuple {
+
+struct LogOptions {
+    // frames are written with a single write once this many bytes are buffered
+    ::std::size_t buffer_bytes{64 * 1024};
+    // fsync after every `sync_every` writes, 0: only on `sync()` and close
+    ::std::size_t sync_every{1};
+};
+
+/* append namedtuple records to a log file, group-committed:
+ * records are buffered and written in batches, and batches are fsync-ed
+ * at the cadence set by LogOptions
+ *
+ * fields are scalars, arrays, namedtuples or types without padding, so that
+ * the padding zeroed between fields is all the padding a record has.
+ *
+ * Usage:
+ *   auto writer = RecordWriter<event>{"events.log"};
+ *   if (!writer.append(ev)) { ... }
+ */
+template<details::record_log::loggable NT>
+struct RecordWriter {
+    explicit RecordWriter(char const* path, LogOptions const options = {}) noexcept
+        : options_{options}, file_{::std::fopen(path, "ab")} {
+        if (this->file_ != nullptr) {
+            ::std::setvbuf(this->file_, nullptr, _IONBF, 0);
+        }
+    }
+
+    RecordWriter(RecordWriter const&) = delete;
+    RecordWriter& operator=(RecordWriter const&) = delete;
+
+    ~RecordWriter() noexcept {
+        if (this->file_ != nullptr) {
+            static_cast<void>(this->sync());
+            ::std::fclose(this->file_);
+        }
+    }
+
+    [[nodiscard]]
+    bool is_open() const noexcept {
+        return this->file_ != nullptr;
+    }
+
+    /* buffer a record, writing the buffer first if the record doesn't fit
+     */
+    [[nodiscard]]
+    bool append(NT const& record) {
+        constexpr auto frame_size = sizeof(details::record_log::frame_header) + sizeof(NT);
+        if (!this->buffer_.empty() && this->buffer_.size() + frame_size > this->options_.buffer_bytes) {
+            if (!this->flush()) {
+                return false;
+            }
+        }
+
+        auto const at = this->buffer_.size();
+        this->buffer_.resize(at + frame_size);
+        auto* const payload = this->buffer_.data() + at + sizeof(details::record_log::frame_header);
+        ::std::memcpy(payload, &record, sizeof(NT));
+        // the frame mustn't depend on whatever padding held
+        for (::std::size_t i{}; i < sizeof(NT); ++i) {
+            if (!details::record_log::field_bytes<NT>[i]) {
+                payload[i] = ::std::byte{};
+            }
+        }
+        auto const header = details::record_log::frame_header{static_cast<::std::uint32_t>(sizeof(NT)),
+                                                              details::record_log::crc32(payload, sizeof(NT)),
+                                                              fingerprint<NT>()};
+        ::std::memcpy(this->buffer_.data() + at, &header, sizeof(header));
+        return true;
+    }
+
+    /* write buffered records, and fsync if it's due
+     *
+     * on a short write the bytes that reached the file are dropped from the buffer,
+     * so the next flush continues the frame it stopped in instead of writing it again
+     */
+    [[nodiscard]]
+    bool flush() noexcept {
+        if (this->file_ == nullptr) {
+            return false;
+        }
+        if (this->buffer_.empty()) {
+            return true;
+        }
+        auto const written = ::std::fwrite(this->buffer_.data(), 1, this->buffer_.size(), this->file_);
+        this->buffer_.erase(this->buffer_.begin(), this->buffer_.begin() + static_cast<::std::ptrdiff_t>(written));
+        if (!this->buffer_.empty()) {
+            return false;
+        }
+        if (this->options_.sync_every != 0 && ++this->unsynced_ >= this->options_.sync_every) {
+            this->unsynced_ = 0;
+            return details::record_log::sync(this->file_);
+        }
+        return true;
+    }
+
+    /* write buffered records and fsync now
+     */
+    [[nodiscard]]
+    bool sync() noexcept {
+        if (!this->flush()) {
+            return false;
+        }
+        this->unsynced_ = 0;
+        return details::record_log::sync(this->file_);
+    }
+
+private:
+    LogOptions options_;
+    ::std::FILE* file_;
+    ::std::vector<::std::byte> buffer_;
+    ::std::size_t unsynced_{};
+};
+
+enum class read_status {
+    ok,
+    // no complete record yet, call again once the writer has appended more
+    end,
+    // a frame failed its CRC or has an unexpected length
+    corrupt,
+    // a frame was written by another schema
+    schema_mismatch,
+};
+
+/* read records from a log file, it can tail a log that is still being written
+ *
+ * Usage:
+ *   auto reader = RecordReader<event>{"events.log"};
+ *   event ev{...};
+ *   while (reader.next(ev) == read_status::ok) { ... }
+ */
+template<details::record_log::loggable NT>
+struct RecordReader {
+    explicit RecordReader(char const* path) noexcept
+        : file_{::std::fopen(path, "rb")} {
+    }
+
+    RecordReader(RecordReader const&) = delete;
+    RecordReader& operator=(RecordReader const&) = delete;
+
+    ~RecordReader() noexcept {
+        if (this->file_ != nullptr) {
+            ::std::fclose(this->file_);
+        }
+    }
+
+    [[nodiscard]]
+    bool is_open() const noexcept {
+        return this->file_ != nullptr;
+    }
+
+    /* read the next record into `record`, which is left untouched unless `ok` is returned
+     */
+    [[nodiscard]]
+    read_status next(NT& record) noexcept {
+        if (this->file_ == nullptr) {
+            return read_status::end;
+        }
+        // after a short read, retry from the start of the incomplete frame
+        if (this->resume_) {
+            ::std::clearerr(this->file_);
+            if (!details::record_log::seek(this->file_, this->offset_)) {
+                return read_status::end;
+            }
+            this->resume_ = false;
+        }
+
+        details::record_log::frame_header header;
+        if (::std::fread(&header, sizeof(header), 1, this->file_) != 1) {
+            this->resume_ = true;
+            return read_status::end;
+        }
+        if (header.fingerprint != fingerprint<NT>()) {
+            this->resume_ = true;
+            return read_status::schema_mismatch;
+        }
+        if (header.length != sizeof(NT)) {
+            this->resume_ = true;
+            return read_status::corrupt;
+        }
+
+        alignas(NT) ::std::byte payload[sizeof(NT)];
+        if (::std::fread(payload, sizeof(NT), 1, this->file_) != 1) {
+            this->resume_ = true;
+            return read_status::end;
+        }
+        if (details::record_log::crc32(payload, sizeof(NT)) != header.crc) {
+            this->resume_ = true;
+            return read_status::corrupt;
+        }
+
+        ::std::memcpy(&record, payload, sizeof(NT));
+        this->offset_ += sizeof(header) + sizeof(NT);
+        return read_status::ok;
+    }
+
+private:
+    ::std::FILE* file_;
+    ::std::uint64_t offset_{};
+    bool resume_{};
+};
+
+}  // namespace ctb::namedtuple
@@ -0,0 +1,96 @@
+#pragma once
+
+#if !__cpp_concepts >= 201907L
+    #error "reflect requires at least c++20"
+#endif
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#include "namedtuple.hh"
+
+namespace ctb::namedtuple {
+
+/* what kind of value a field holds, the same classification the fingerprint hashes
+ */
+using type_tag = details::fingerprint::kind;
+
+/* runtime description of a field of a namedtuple
+ *
+ * `nested` describes the fields of a field that is itself a namedtuple, and is empty otherwise.
+ */
+struct field_info {
+    ::std::string_view name;
+    ::std::size_t offset;
+    ::std::size_t size;
+    ::std::size_t align;
+    type_tag tag;
+    ::std::span<field_info const> nested;
+};
+
+namespace details::reflect {
+
+/* a name as utf-8 chars, stored once however many schemas share it
+ */
+template<auto Key>
+constexpr auto name = string::code_cvt<char>(name_of<Key>);
+
+template<typename NT>
+struct of_;
+
+template<typename T>
+[[nodiscard]]
+consteval ::std::span<field_info const> nested_of() noexcept {
+    if constexpr (is_namedtuple<T>) {
+        return of_<T>::value;
+    } else {
+        return {};
+    }
+}
+
+template<auto... Keys, typename... Args>
+struct of_<NamedTuple<names<Keys...>, Args...>> {
+    using type = NamedTuple<names<Keys...>, Args...>;
+
+    static constexpr auto value = []<::std::size_t... I>(::std::index_sequence<I...>) {
+        return ::std::array<field_info, sizeof...(Args)>{
+            field_info{::std::string_view{name<Keys>.begin(), name<Keys>.size()}, layout::of_<type>::offsets[I],
+                       sizeof(Args), alignof(Args), fingerprint::kind_of<::std::remove_cv_t<Args>>(),
+                       nested_of<::std::remove_cv_t<Args>>()}...};
+    }(::std::index_sequence_for<Args...>{});
+};
+
+}  // namespace details::reflect
+
+/* the fields of a namedtuple as a table in read-only data, emitted once per schema,
+ * so generic code can loop over it at runtime instead of being instantiated for every schema
+ *
+ * namedtuples with reference elements, like those of `named_tie`, have no layout to describe.
+ *
+ * Usage:
+ *   for (auto const& field : fields<decltype(nt)>) {
+ *       auto const* value = reinterpret_cast<char const*>(&nt) + field.offset;
+ *   }
+ */
+template<is_namedtuple NT>
+    requires (details::layout::is_laid_out<::std::remove_cvref_t<NT>>)
+constexpr ::std::span<field_info const> fields = details::reflect::of_<::std::remove_cvref_t<NT>>::value;
+
+/* the field named `name`, or nullptr
+ */
+[[nodiscard]]
+constexpr field_info const* find_field(::std::span<field_info const> const fields,
+                                       ::std::string_view const name) noexcept {
+    for (auto const& field : fields) {
+        if (field.name == name) {
+            return &field;
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace ctb::namedtuple
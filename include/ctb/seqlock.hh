@@ -0,0 +1,188 @@
+#pragma once
+
+#if !__cpp_concepts >= 201907L
+    #error "seqlock requires at least c++20"
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "namedtuple.hh"
+
+namespace ctb::namedtuple::details::seqlock {
+
+using word = ::std::uint64_t;
+
+[[nodiscard]]
+constexpr ::std::size_t words_of(::std::size_t const size) noexcept {
+    return (size + sizeof(word) - 1) / sizeof(word);
+}
+
+// a separate cache line for the sequence, so readers spinning on it don't
+// share a line with the first words of the payload
+constexpr ::std::size_t cache_line{64};
+
+}  // namespace ctb::namedtuple::details::seqlock
+
+namespace ctb::namedtuple {
+
+/* a trivially copyable namedtuple shared by a single writer and many readers
+ *
+ * the writer makes the sequence odd, writes, and makes it even again;
+ * readers copy the payload and retry if the sequence was odd or changed.
+ * readers never block the writer nor write to shared memory, so they scale
+ * with the number of readers.
+ *
+ * the payload is kept in relaxed atomic words, so that the racy copy
+ * is not a data race.
+ *
+ * Usage:
+ *   auto quote = SeqlockNamedTuple<quote_t>{initial};
+ *   quote.store(new_quote);                     // writer thread
+ *   auto snapshot = quote.load();               // any thread
+ *   auto [bid, ask] = quote.load<"bid", "ask">();
+ */
+template<is_namedtuple NT>
+    requires (::std::is_trivially_copyable_v<NT>)
+struct SeqlockNamedTuple {
+    using value_type = NT;
+
+    explicit SeqlockNamedTuple(NT const& initial) noexcept {
+        this->store(initial);
+    }
+
+    SeqlockNamedTuple(SeqlockNamedTuple const&) = delete;
+    SeqlockNamedTuple& operator=(SeqlockNamedTuple const&) = delete;
+
+    /* replace the whole value, only one thread may write
+     */
+    void store(NT const& value) noexcept {
+        ::std::array<::std::byte, sizeof(words_)> bytes{};
+        ::std::memcpy(bytes.data(), &value, sizeof(NT));
+        this->write(bytes, 0, words_count);
+    }
+
+    /* replace one field, only one thread may write
+     */
+    template<string::String str, typename T>
+    void store(T&& value) noexcept {
+        constexpr auto index = details::get_index<str, typename NT::names>();
+        using field_type = ::std::tuple_element_t<index, NT>;
+        constexpr auto first = offset_of<index, NT>();
+        constexpr auto begin = first / sizeof(details::seqlock::word);
+        constexpr auto end = details::seqlock::words_of(first + sizeof(field_type));
+
+        // the writer is the only one modifying the words, so it can read them without the sequence
+        ::std::array<::std::byte, sizeof(words_)> bytes{};
+        for (auto i = begin; i < end; ++i) {
+            auto const w = this->words_[i].load(::std::memory_order_relaxed);
+            ::std::memcpy(bytes.data() + i * sizeof(w), &w, sizeof(w));
+        }
+        auto const field = static_cast<field_type>(::std::forward<T>(value));
+        ::std::memcpy(bytes.data() + first, &field, sizeof(field));
+        this->write(bytes, begin, end);
+    }
+
+    /* a consistent snapshot of the whole value
+     */
+    [[nodiscard]]
+    NT load() const noexcept {
+        ::std::array<::std::byte, sizeof(NT)> bytes;
+        this->read(bytes, 0, words_count);
+        return ::std::bit_cast<NT>(bytes);
+    }
+
+    /* a consistent snapshot of some fields, only the words holding them are copied
+     */
+    template<string::String... Strs>
+        requires (sizeof...(Strs) > 0)
+    [[nodiscard]]
+    auto load() const noexcept {
+        constexpr ::std::size_t indexes[]{details::get_index<Strs, typename NT::names>()...};
+        constexpr auto begin = [&] {
+            auto res = sizeof(NT);
+            for (auto const i : indexes) {
+                res = ::std::min(res, details::layout::of_<NT>::offsets[i]);
+            }
+            return res / sizeof(details::seqlock::word);
+        }();
+        constexpr auto end = [&] {
+            ::std::size_t res{};
+            for (auto const i : indexes) {
+                res = ::std::max(res, details::layout::of_<NT>::offsets[i] + field_sizes[i]);
+            }
+            return details::seqlock::words_of(res);
+        }();
+
+        ::std::array<::std::byte, sizeof(words_)> bytes;
+        this->read(bytes, begin, end);
+        return [&]<::std::size_t... I>(::std::index_sequence<I...>) {
+            return NamedTuple<names<Strs...>, ::std::tuple_element_t<indexes[I], NT>...>{
+                field_from<indexes[I]>(bytes)...};
+        }(::std::index_sequence_for<decltype(Strs)...>{});
+    }
+
+private:
+    static constexpr auto words_count = details::seqlock::words_of(sizeof(NT));
+    static constexpr auto field_sizes = []<::std::size_t... I>(::std::index_sequence<I...>) {
+        return ::std::array<::std::size_t, sizeof...(I)>{sizeof(::std::tuple_element_t<I, NT>)...};
+    }(::std::make_index_sequence<::std::tuple_size_v<NT>>{});
+
+    alignas(details::seqlock::cache_line) ::std::atomic<::std::uint64_t> seq_{};
+    alignas(details::seqlock::cache_line) ::std::atomic<details::seqlock::word> words_[words_count]{};
+
+    template<::std::size_t I, typename Bytes>
+    [[nodiscard]]
+    static auto field_from(Bytes const& bytes) noexcept {
+        using field_type = ::std::tuple_element_t<I, NT>;
+        ::std::array<::std::byte, sizeof(field_type)> field;
+        ::std::memcpy(field.data(), bytes.data() + offset_of<I, NT>(), sizeof(field_type));
+        return ::std::bit_cast<field_type>(field);
+    }
+
+    template<typename Bytes>
+    void write(Bytes const& bytes, ::std::size_t const begin, ::std::size_t const end) noexcept {
+        auto const seq = this->seq_.load(::std::memory_order_relaxed);
+        this->seq_.store(seq + 1, ::std::memory_order_relaxed);
+        ::std::atomic_thread_fence(::std::memory_order_release);
+        for (auto i = begin; i < end; ++i) {
+            details::seqlock::word w;
+            ::std::memcpy(&w, bytes.data() + i * sizeof(w), sizeof(w));
+            this->words_[i].store(w, ::std::memory_order_relaxed);
+        }
+        this->seq_.store(seq + 2, ::std::memory_order_release);
+    }
+
+    /* copy words [begin, end) into `bytes` at their own offsets
+     */
+    template<typename Bytes>
+    void read(Bytes& bytes, ::std::size_t const begin, ::std::size_t const end) const noexcept {
+        details::seqlock::word copy[words_count];
+        for (;;) {
+            auto const before = this->seq_.load(::std::memory_order_acquire);
+            if (before % 2 != 0) {
+                continue;
+            }
+            for (auto i = begin; i < end; ++i) {
+                copy[i] = this->words_[i].load(::std::memory_order_relaxed);
+            }
+            ::std::atomic_thread_fence(::std::memory_order_acquire);
+            if (this->seq_.load(::std::memory_order_relaxed) == before) {
+                break;
+            }
+        }
+        auto const first = begin * sizeof(details::seqlock::word);
+        auto const last = ::std::min(end * sizeof(details::seqlock::word), bytes.size());
+        ::std::memcpy(bytes.data() + first, reinterpret_cast<::std::byte const*>(copy) + first, last - first);
+    }
+};
+
+}  // namespace ctb::namedtuple
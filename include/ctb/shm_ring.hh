@@ -0,0 +1,249 @@
+#pragma once
+
+#if !__cpp_concepts >= 201907L
+    #error "shm_ring requires at least c++20"
+#endif
+
+// shared memory rings need POSIX shm_open and mmap, the header is empty elsewhere
+#if defined(__unix__) || defined(__APPLE__)
+    #define CTB_SHM_RING_SUPPORT
+#endif
+
+#ifdef CTB_SHM_RING_SUPPORT
+
+    #include <atomic>
+    #include <bit>
+    #include <cerrno>
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+    #include <new>
+    #include <type_traits>
+    #include <utility>
+
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+
+    #include "namedtuple.hh"
+
+namespace ctb::namedtuple::details::shm_ring {
+
+// "ctbring1", stored last by the creator, so attaching to a segment that is
+// still being set up fails instead of reading a half written header
+constexpr ::std::uint64_t magic{0x31676e6972627463};
+
+constexpr ::std::size_t cache_line{64};
+
+static_assert(::std::atomic<::std::uint64_t>::is_always_lock_free, "shm_ring needs lock free 64-bit atomics");
+
+/* the start of the segment, followed by `capacity` records
+ *
+ * the producer and the consumer each own one index, on its own cache line,
+ * both only ever grow and are reduced modulo the capacity when used
+ */
+struct header {
+    ::std::atomic<::std::uint64_t> magic;
+    ::std::uint64_t fingerprint;
+    ::std::uint64_t record_size;
+    ::std::uint64_t capacity;
+    alignas(cache_line) ::std::atomic<::std::uint64_t> head;
+    alignas(cache_line) ::std::atomic<::std::uint64_t> tail;
+};
+
+template<typename NT>
+[[nodiscard]]
+constexpr ::std::size_t records_offset() noexcept {
+    constexpr auto align = alignof(NT) > cache_line ? alignof(NT) : cache_line;
+    return (sizeof(header) + align - 1) / align * align;
+}
+
+}  // namespace ctb::namedtuple::details::shm_ring
+
+namespace ctb::namedtuple {
+
+enum class shm_status {
+    ok,
+    // the segment can't be opened, created or mapped, is not set up yet, or is not a valid ring
+    unavailable,
+    // the segment was created for another schema
+    schema_mismatch,
+    // `create` found a segment of that name, which may be in use
+    exists,
+};
+
+/* a single-producer/single-consumer ring of namedtuple records in POSIX shared memory
+ *
+ * one process creates the segment, the other attaches to it by name; the
+ * segment header carries the schema fingerprint, so attaching with another
+ * schema fails. records are copied in and out, nothing is serialized.
+ *
+ * Usage:
+ *   auto ring = ShmRing<event>::create("/events", 1024);   // producer
+ *   auto ring = ShmRing<event>::attach("/events");         // consumer
+ *   if (ring.status() == shm_status::ok) { ... }
+ *   ring.try_push(ev);
+ *   while (ring.try_pop(ev)) { ... }
+ *   ShmRing<event>::unlink("/events");
+ */
+template<is_namedtuple NT>
+    requires (::std::is_trivially_copyable_v<NT>)
+struct ShmRing {
+    /* create the segment `name`, the capacity is rounded up to a power of 2
+     *
+     * fails with `exists` if the segment is already there, as resetting it would break the ring
+     * of whoever uses it; `unlink` a stale segment first
+     */
+    [[nodiscard]]
+    static ShmRing create(char const* name, ::std::size_t const capacity) noexcept {
+        auto ring = ShmRing{};
+        auto const fd = ::shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd == -1) {
+            if (errno == EEXIST) {
+                ring.status_ = shm_status::exists;
+            }
+            return ring;
+        }
+        auto const records = ::std::bit_ceil(capacity < 2 ? ::std::size_t{2} : capacity);
+        auto const size = details::shm_ring::records_offset<NT>() + records * sizeof(NT);
+        if (::ftruncate(fd, static_cast<::off_t>(size)) != 0 || !ring.map(fd, size)) {
+            ::close(fd);
+            ::shm_unlink(name);
+            return ring;
+        }
+        ::close(fd);
+
+        auto* const header = new (ring.segment_) details::shm_ring::header{};
+        header->fingerprint = fingerprint<NT>();
+        header->record_size = sizeof(NT);
+        header->capacity = records;
+        header->magic.store(details::shm_ring::magic, ::std::memory_order_release);
+        ring.status_ = shm_status::ok;
+        return ring;
+    }
+
+    /* attach to the segment `name` created by `create`
+     */
+    [[nodiscard]]
+    static ShmRing attach(char const* name) noexcept {
+        auto ring = ShmRing{};
+        auto const fd = ::shm_open(name, O_RDWR, 0600);
+        if (fd == -1) {
+            return ring;
+        }
+        struct ::stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<::std::size_t>(st.st_size) < details::shm_ring::records_offset<NT>() ||
+            !ring.map(fd, static_cast<::std::size_t>(st.st_size))) {
+            ::close(fd);
+            return ring;
+        }
+        ::close(fd);
+
+        auto const* const header = ring.header_();
+        if (header->magic.load(::std::memory_order_acquire) != details::shm_ring::magic) {
+            return ring;
+        }
+        if (header->fingerprint != fingerprint<NT>() || header->record_size != sizeof(NT)) {
+            ring.status_ = shm_status::schema_mismatch;
+            return ring;
+        }
+        // records are indexed by masking with `capacity - 1`
+        if (!::std::has_single_bit(header->capacity) ||
+            header->capacity > (ring.size_ - details::shm_ring::records_offset<NT>()) / sizeof(NT)) {
+            return ring;
+        }
+        ring.status_ = shm_status::ok;
+        return ring;
+    }
+
+    /* remove the name of the segment, mapped rings keep working
+     */
+    static bool unlink(char const* name) noexcept {
+        return ::shm_unlink(name) == 0;
+    }
+
+    ShmRing(ShmRing&& other) noexcept
+        : segment_{::std::exchange(other.segment_, nullptr)}, size_{other.size_}, status_{other.status_} {
+    }
+
+    ShmRing(ShmRing const&) = delete;
+    ShmRing& operator=(ShmRing const&) = delete;
+
+    ~ShmRing() noexcept {
+        if (this->segment_ != nullptr) {
+            ::munmap(this->segment_, this->size_);
+        }
+    }
+
+    [[nodiscard]]
+    shm_status status() const noexcept {
+        return this->status_;
+    }
+
+    /* copy `record` into the ring, false if it is full; only one thread in one process may push
+     */
+    [[nodiscard]]
+    bool try_push(NT const& record) noexcept {
+        auto* const header = this->header_();
+        auto const head = header->head.load(::std::memory_order_relaxed);
+        if (head - header->tail.load(::std::memory_order_acquire) == header->capacity) {
+            return false;
+        }
+        ::std::memcpy(this->slot(head), &record, sizeof(NT));
+        header->head.store(head + 1, ::std::memory_order_release);
+        return true;
+    }
+
+    /* copy the oldest record out of the ring, false if it is empty; only one thread in one process may pop
+     */
+    [[nodiscard]]
+    bool try_pop(NT& record) noexcept {
+        auto* const header = this->header_();
+        auto const tail = header->tail.load(::std::memory_order_relaxed);
+        if (tail == header->head.load(::std::memory_order_acquire)) {
+            return false;
+        }
+        ::std::memcpy(&record, this->slot(tail), sizeof(NT));
+        header->tail.store(tail + 1, ::std::memory_order_release);
+        return true;
+    }
+
+    [[nodiscard]]
+    ::std::size_t capacity() const noexcept {
+        return static_cast<::std::size_t>(this->header_()->capacity);
+    }
+
+private:
+    void* segment_{};
+    ::std::size_t size_{};
+    shm_status status_{shm_status::unavailable};
+
+    ShmRing() noexcept = default;
+
+    [[nodiscard]]
+    bool map(int const fd, ::std::size_t const size) noexcept {
+        auto* const segment = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (segment == MAP_FAILED) {
+            return false;
+        }
+        this->segment_ = segment;
+        this->size_ = size;
+        return true;
+    }
+
+    [[nodiscard]]
+    details::shm_ring::header* header_() const noexcept {
+        return static_cast<details::shm_ring::header*>(this->segment_);
+    }
+
+    [[nodiscard]]
+    ::std::byte* slot(::std::uint64_t const index) const noexcept {
+        auto const i = static_cast<::std::size_t>(index & (this->header_()->capacity - 1));
+        return static_cast<::std::byte*>(this->segment_) + details::shm_ring::records_offset<NT>() + i * sizeof(NT);
+    }
+};
+
+}  // namespace ctb::namedtuple
+
+#endif  // CTB_SHM_RING_SUPPORT
@@ -0,0 +1,301 @@
+#pragma once
+
+#if !__cpp_concepts >= 201907L
+    #error "sparse requires at least c++20"
+#endif
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "namedtuple.hh"
+
+namespace ctb::namedtuple::details::sparse {
+
+template<typename NT>
+concept can_sparse = ::std::is_trivially_copyable_v<NT> && is_namedtuple<NT>;
+
+struct shape {
+    ::std::size_t size;
+    ::std::size_t align;
+
+    [[nodiscard]]
+    constexpr bool operator==(shape const&) const noexcept = default;
+};
+
+/* fields of the same size and alignment form a group, whose present values are packed
+ * together in field order. groups follow each other by decreasing alignment, and a size
+ * is a multiple of its alignment, so every value is aligned without any padding.
+ */
+template<typename... Args>
+struct groups_ {
+    static constexpr ::std::size_t words{(sizeof...(Args) + 63) / 64};
+    static constexpr ::std::array<shape, sizeof...(Args)> shapes{shape{sizeof(Args), alignof(Args)}...};
+
+    static constexpr ::std::size_t count = [] {
+        ::std::size_t res{};
+        for (::std::size_t i{}; i < shapes.size(); ++i) {
+            res += ::std::find(shapes.begin(), shapes.begin() + i, shapes[i]) == shapes.begin() + i;
+        }
+        return res;
+    }();
+
+    // the shape of every group
+    static constexpr auto of = [] {
+        ::std::array<shape, count> res{};
+        ::std::size_t n{};
+        for (auto const s : shapes) {
+            if (::std::find(res.begin(), res.begin() + n, s) == res.begin() + n) {
+                res[n++] = s;
+            }
+        }
+        ::std::sort(res.begin(), res.end(), [](shape const lhs, shape const rhs) {
+            return lhs.align > rhs.align || (lhs.align == rhs.align && lhs.size > rhs.size);
+        });
+        return res;
+    }();
+
+    // the group of every field
+    static constexpr auto group_of = [] {
+        ::std::array<::std::size_t, sizeof...(Args)> res{};
+        for (::std::size_t i{}; i < shapes.size(); ++i) {
+            res[i] = static_cast<::std::size_t>(::std::find(of.begin(), of.end(), shapes[i]) - of.begin());
+        }
+        return res;
+    }();
+
+    // masks[g][w] are the fields of group g in word w
+    static constexpr auto masks = [] {
+        ::std::array<::std::array<::std::uint64_t, words>, count> res{};
+        for (::std::size_t i{}; i < shapes.size(); ++i) {
+            res[group_of[i]][i / 64] |= ::std::uint64_t{1} << i % 64;
+        }
+        return res;
+    }();
+};
+
+/* the unit `values` grows by, as large as the largest alignment so that it is aligned for any field
+ */
+template<typename... Args>
+struct chunk {
+    alignas(Args...) ::std::byte bytes[::std::max({alignof(Args)...})];
+};
+
+}  // namespace ctb::namedtuple::details::sparse
+
+namespace ctb::namedtuple {
+
+template<details::sparse::can_sparse NT>
+struct SparseNamedTuple;
+
+/* a namedtuple where every field may be absent, for wide schemas that are mostly empty
+ *
+ * only the present fields are stored, each in its own size, with a bit per field telling
+ * whether it is present. fields are grouped by size and alignment (see `details::sparse::groups_`),
+ * and the place of a field is where its group starts, kept in `bases`, plus its rank in its group:
+ * the count of the words before its own is kept in `ranks`, so finding it is a single popcount.
+ */
+template<details::is_names Names, typename... Args>
+struct SparseNamedTuple<NamedTuple<Names, Args...>> {
+    using names = Names;
+    using dense_type = NamedTuple<Names, Args...>;
+    using groups = details::sparse::groups_<Args...>;
+    using chunk_type = details::sparse::chunk<Args...>;
+    static constexpr ::std::size_t words_count{groups::words};
+
+    ::std::array<::std::uint64_t, words_count> present{};
+    // ranks[g][w] is the number of present fields of group g in the words before w
+    ::std::array<::std::array<::std::uint16_t, words_count>, groups::count> ranks{};
+    // bases[g] is the byte offset of group g in `values`, and the last one the bytes in use
+    ::std::array<::std::size_t, groups::count + 1> bases{};
+    // the present values packed by group, the last chunk is partly used
+    ::std::vector<chunk_type> values;
+
+    static_assert(sizeof...(Args) <= 0xffff, "ctb::namedtuple::SparseNamedTuple: too many fields");
+
+    template<::std::size_t I>
+    [[nodiscard]]
+    constexpr bool has() const noexcept {
+        return (this->present[I / 64] >> I % 64 & 1) != 0;
+    }
+
+    template<string::String str>
+    [[nodiscard]]
+    constexpr bool has() const noexcept {
+        return this->has<details::get_index<str, names>()>();
+    }
+
+    /* the number of present fields
+     */
+    [[nodiscard]]
+    constexpr ::std::size_t size() const noexcept {
+        ::std::size_t res{};
+        for (auto const word : this->present) {
+            res += static_cast<::std::size_t>(::std::popcount(word));
+        }
+        return res;
+    }
+
+    /* the number of present fields in the group `group`
+     */
+    [[nodiscard]]
+    constexpr ::std::size_t count(::std::size_t const group) const noexcept {
+        return (this->bases[group + 1] - this->bases[group]) / groups::of[group].size;
+    }
+
+    /* the bytes taken by the present values
+     */
+    [[nodiscard]]
+    constexpr ::std::size_t bytes() const noexcept {
+        return this->bases.back();
+    }
+
+    /* the number of present fields of the group of field I before it
+     */
+    template<::std::size_t I>
+    [[nodiscard]]
+    constexpr ::std::size_t rank() const noexcept {
+        constexpr auto group = groups::group_of[I];
+        auto const below = groups::masks[group][I / 64] & ((::std::uint64_t{1} << I % 64) - 1);
+        return this->ranks[group][I / 64] + static_cast<::std::size_t>(::std::popcount(this->present[I / 64] & below));
+    }
+
+    /* the byte offset of field I in `values`, or where it would be inserted if it is absent
+     */
+    template<::std::size_t I>
+    [[nodiscard]]
+    constexpr ::std::size_t offset() const noexcept {
+        constexpr auto group = groups::group_of[I];
+        return this->bases[group] + this->rank<I>() * groups::of[group].size;
+    }
+
+    void clear() noexcept {
+        this->present = {};
+        this->ranks = {};
+        this->bases = {};
+        this->values.clear();
+    }
+};
+
+namespace details::sparse {
+
+template<::std::size_t I, typename Sparse>
+[[nodiscard]]
+auto* field_ptr(Sparse& sparse) noexcept {
+    using T = ::std::tuple_element_t<I, typename ::std::remove_const_t<Sparse>::dense_type>;
+    using pointer = ::std::conditional_t<::std::is_const_v<Sparse>, T const*, T*>;
+    using byte_pointer = ::std::conditional_t<::std::is_const_v<Sparse>, ::std::byte const*, ::std::byte*>;
+    if (!sparse.template has<I>()) {
+        return pointer{};
+    }
+    auto const bytes = reinterpret_cast<byte_pointer>(sparse.values.data());
+    return ::std::launder(reinterpret_cast<pointer>(bytes + sparse.template offset<I>()));
+}
+
+/* resize `sparse` to hold `bytes` bytes of values
+ */
+template<typename Sparse>
+void resize(Sparse& sparse, ::std::size_t const bytes) {
+    using chunk_type = typename Sparse::chunk_type;
+    sparse.values.resize((bytes + sizeof(chunk_type) - 1) / sizeof(chunk_type));
+}
+
+}  // namespace details::sparse
+
+/* get a field of a sparse namedtuple, nullptr if it is absent
+ *
+ * Usage: if (auto const* rpm = get<"rpm">(sparse)) { ... }
+ */
+template<::std::size_t I, typename NT>
+[[nodiscard]]
+auto* get(SparseNamedTuple<NT>& sparse) noexcept {
+    return details::sparse::field_ptr<I>(sparse);
+}
+
+template<::std::size_t I, typename NT>
+[[nodiscard]]
+auto* get(SparseNamedTuple<NT> const& sparse) noexcept {
+    return details::sparse::field_ptr<I>(sparse);
+}
+
+template<string::String str, typename NT>
+[[nodiscard]]
+auto* get(SparseNamedTuple<NT>& sparse) noexcept {
+    return details::sparse::field_ptr<details::get_index<str, typename NT::names>()>(sparse);
+}
+
+template<string::String str, typename NT>
+[[nodiscard]]
+auto* get(SparseNamedTuple<NT> const& sparse) noexcept {
+    return details::sparse::field_ptr<details::get_index<str, typename NT::names>()>(sparse);
+}
+
+/* write a field, inserting it if it is absent
+ *
+ * Usage: set<"rpm">(sparse, 3000)
+ */
+template<::std::size_t I, typename NT>
+void set(SparseNamedTuple<NT>& sparse, ::std::tuple_element_t<I, NT> const& value) {
+    using T = ::std::tuple_element_t<I, NT>;
+    if (auto* const field = get<I>(sparse)) {
+        *field = value;
+        return;
+    }
+    auto const used = sparse.bytes();
+    auto const at = sparse.template offset<I>();
+    details::sparse::resize(sparse, used + sizeof(T));
+    auto* const bytes = reinterpret_cast<::std::byte*>(sparse.values.data());
+    ::std::memmove(bytes + at + sizeof(T), bytes + at, used - at);
+    ::new (static_cast<void*>(bytes + at)) T(value);
+    sparse.present[I / 64] |= ::std::uint64_t{1} << I % 64;
+    constexpr auto group = SparseNamedTuple<NT>::groups::group_of[I];
+    for (auto w = I / 64 + 1; w < sparse.words_count; ++w) {
+        ++sparse.ranks[group][w];
+    }
+    for (auto g = group + 1; g < sparse.bases.size(); ++g) {
+        sparse.bases[g] += sizeof(T);
+    }
+}
+
+template<string::String str, typename NT, typename T>
+void set(SparseNamedTuple<NT>& sparse, T const& value) {
+    set<details::get_index<str, typename NT::names>()>(sparse, value);
+}
+
+/* remove a field, if it is present
+ */
+template<::std::size_t I, typename NT>
+void erase(SparseNamedTuple<NT>& sparse) noexcept {
+    using T = ::std::tuple_element_t<I, NT>;
+    if (!sparse.template has<I>()) {
+        return;
+    }
+    auto const used = sparse.bytes();
+    auto const at = sparse.template offset<I>();
+    auto* const bytes = reinterpret_cast<::std::byte*>(sparse.values.data());
+    ::std::memmove(bytes + at, bytes + at + sizeof(T), used - at - sizeof(T));
+    details::sparse::resize(sparse, used - sizeof(T));
+    sparse.present[I / 64] &= ~(::std::uint64_t{1} << I % 64);
+    constexpr auto group = SparseNamedTuple<NT>::groups::group_of[I];
+    for (auto w = I / 64 + 1; w < sparse.words_count; ++w) {
+        --sparse.ranks[group][w];
+    }
+    for (auto g = group + 1; g < sparse.bases.size(); ++g) {
+        sparse.bases[g] -= sizeof(T);
+    }
+}
+
+template<string::String str, typename NT>
+void erase(SparseNamedTuple<NT>& sparse) noexcept {
+    erase<details::get_index<str, typename NT::names>()>(sparse);
+}
+
+}  // namespace ctb::namedtuple
@@ -0,0 +1,144 @@
+#pragma once
+
+#if !__cpp_concepts >= 201907L
+    #error "static_table requires at least c++20"
+#endif
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdlib>
+#include <type_traits>
+
+#include "namedtuple.hh"
+#include "vector.hh"
+
+namespace ctb::namedtuple::details {
+
+template<string::String Key, is_namedtuple Row>
+using key_t_ = ::std::remove_cvref_t<decltype(get<Key>(::std::declval<Row>()))>;
+
+/* how many interpolation probes `StaticTable::find` makes before it falls
+ * back to binary search on the remaining range, this bounds the worst case
+ * on skewed keys to O(log N)
+ */
+constexpr ::std::size_t interpolation_probes{3};
+
+/* not constexpr, so a table with duplicate keys fails to compile when it is built at compile time
+ */
+[[noreturn]]
+inline void static_table_duplicate_key() noexcept {
+    ::std::abort();
+}
+
+}  // namespace ctb::namedtuple::details
+
+namespace ctb::namedtuple {
+
+/* A read-only table of NamedTuple rows sorted by the field `Key` at compile time
+ *
+ * keys are stored contiguously in a `Vector` apart from the rows, so a lookup
+ * only touches the key array until it hits, and then reads exactly one row.
+ * the rows keep their own key too: `find` and iteration hand out whole `Row`s,
+ * so the copy costs `sizeof(key_type)` per row in exchange for a dense key array.
+ */
+template<string::String Key, is_namedtuple Row, ::std::size_t N>
+    requires (::std::integral<details::key_t_<Key, Row>>)
+struct StaticTable {
+    static_assert(N > 0, "ctb::namedtuple::static_table: empty table");
+
+    using row_type = Row;
+    using key_type = details::key_t_<Key, Row>;
+    static constexpr auto key{Key};
+
+    vector::Vector<key_type, N> keys;
+    ::std::array<Row, N> rows;
+
+    [[nodiscard]]
+    static constexpr ::std::size_t size() noexcept {
+        return N;
+    }
+
+    [[nodiscard]]
+    constexpr auto begin() const noexcept {
+        return this->rows.begin();
+    }
+
+    [[nodiscard]]
+    constexpr auto end() const noexcept {
+        return this->rows.end();
+    }
+
+    /* find a row by its key, returns nullptr if there is no such row
+     *
+     * Usage: table.find<"id">(42)
+     */
+    template<string::String Name>
+    [[nodiscard]]
+    constexpr Row const* find(key_type const value) const noexcept {
+        static_assert(Name == Key, "ctb::namedtuple::static_table: table is not sorted by this field");
+
+        auto const* const first = this->keys.data();
+        ::std::size_t lo{}, hi{N - 1};
+        if (value < first[lo] || first[hi] < value) {
+            return nullptr;
+        }
+
+        // invariant: first[lo] <= value <= first[hi]
+        for (::std::size_t probe{}; probe < details::interpolation_probes; ++probe) {
+            // distinct 64-bit keys may round to the same double, those are left to the binary search
+            auto const span = static_cast<double>(first[hi]) - static_cast<double>(first[lo]);
+            if (span == 0) {
+                break;
+            }
+            auto const ratio = (static_cast<double>(value) - static_cast<double>(first[lo])) / span;
+            auto const pos = ::std::min(lo + static_cast<::std::size_t>(ratio * static_cast<double>(hi - lo)), hi);
+            if (first[pos] < value) {
+                lo = pos + 1;
+            } else if (value < first[pos]) {
+                hi = pos - 1;
+            } else {
+                return &this->rows[pos];
+            }
+            if (hi < lo || value < first[lo] || first[hi] < value) {
+                return nullptr;
+            }
+        }
+
+        auto const it = ::std::lower_bound(first + lo, first + hi + 1, value);
+        if (it == first + hi + 1 || *it != value) {
+            return nullptr;
+        }
+        return &this->rows[static_cast<::std::size_t>(it - first)];
+    }
+};
+
+/* build a StaticTable sorted by the field `Key`
+ * keys must be unique, duplicates fail to compile in constant evaluation and abort at runtime
+ *
+ * Usage: constexpr auto table = static_table<"id">(make_namedtuple<"id", "name">(2, "b"), ...);
+ */
+template<string::String Key, is_namedtuple Row, ::std::same_as<Row>... Rows>
+[[nodiscard]]
+constexpr auto static_table(Row const& row, Rows const&... rows) noexcept {
+    using table_type = StaticTable<Key, Row, sizeof...(Rows) + 1>;
+    using key_type = typename table_type::key_type;
+
+    auto sorted = ::std::array<Row, sizeof...(Rows) + 1>{row, rows...};
+    ::std::sort(sorted.begin(), sorted.end(), [](Row const& lhs, Row const& rhs) {
+        return get<Key>(lhs) < get<Key>(rhs);
+    });
+
+    key_type keys_[sizeof...(Rows) + 1]{};
+    for (::std::size_t i{}; i < sorted.size(); ++i) {
+        keys_[i] = get<Key>(sorted[i]);
+        if (i != 0 && keys_[i - 1] == keys_[i]) {
+            details::static_table_duplicate_key();
+        }
+    }
+
+    return table_type{vector::Vector<key_type, sizeof...(Rows) + 1>{keys_}, sorted};
+}
+
+}  // namespace ctb::namedtuple
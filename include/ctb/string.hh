@@ -83,6 +83,19 @@ concept is_utf32 =
 
 }  // namespace details::transcoding
 
+namespace details {
+
+/* code units are compared as unsigned values,
+ * so the utf-8 of a char string equals the utf-8 of a char8_t string
+ */
+template<is_char Char_l, is_char Char_r>
+[[nodiscard]]
+constexpr bool same_code_unit(Char_l const lhs, Char_r const rhs) noexcept {
+    return static_cast<::std::make_unsigned_t<Char_l>>(lhs) == static_cast<::std::make_unsigned_t<Char_r>>(rhs);
+}
+
+}  // namespace details
+
 /* class string
  *
  * A string literal that can be used in template.
@@ -152,7 +165,7 @@ struct String {
     [[nodiscard]]
     constexpr bool operator==(Char_r const (&other)[N_r]) const noexcept {
         if constexpr (N <= N_r) {
-            if (!::std::equal(this->str.begin(), this->str.end() - 1, other)) {
+            if (!::std::equal(this->str.begin(), this->str.end() - 1, other, details::same_code_unit<Char, Char_r>)) {
                 return false;
             }
             for (::std::size_t i{N - 1}; i < N_r; ++i) {
@@ -162,7 +175,7 @@ struct String {
             }
             return true;
         } else {
-            if (!::std::equal(other, other + N_r - 1, this->str.data())) {
+            if (!::std::equal(other, other + N_r - 1, this->str.data(), details::same_code_unit<Char_r, Char>)) {
                 return false;
             }
             for (::std::size_t i{N_r - 1}; i < N; ++i) {
@@ -185,7 +198,8 @@ struct String {
     [[nodiscard]]
     constexpr bool operator==(::std::basic_string_view<Char_r> const& other) const noexcept {
         if (N < other.size()) {
-            if (!::std::equal(this->str.begin(), this->str.end() - 1, other.begin())) {
+            if (!::std::equal(this->str.begin(), this->str.end() - 1, other.begin(),
+                              details::same_code_unit<Char, Char_r>)) {
                 return false;
             }
             for (::std::size_t i{N - 1}; i < other.size(); ++i) {
@@ -195,7 +209,7 @@ struct String {
             }
             return true;
         } else {
-            if (!::std::equal(other.begin(), other.end(), this->str.data())) {
+            if (!::std::equal(other.begin(), other.end(), this->str.data(), details::same_code_unit<Char_r, Char>)) {
                 return false;
             }
             for (::std::size_t i{other.size()}; i < N; ++i) {
@@ -0,0 +1,846 @@
+#pragma once
+
+#if !__cpp_concepts >= 201907L
+    #error "table requires at least c++20"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "namedtuple.hh"
+
+namespace ctb::namedtuple {
+
+namespace details::zone {
+
+/* rows of a block that a Zone summarizes
+ */
+constexpr ::std::size_t block_rows{4096};
+
+template<typename T>
+struct value_type_ {
+    using type = T;
+};
+
+template<typename T>
+struct value_type_<::std::optional<T>> {
+    using type = T;
+};
+
+/* the type statistics are kept in, `std::optional<T>` columns keep them in T
+ */
+template<typename T>
+using value_type = typename value_type_<T>::type;
+
+template<typename T>
+concept has_zones = ::std::totally_ordered<value_type<T>> && ::std::default_initializable<value_type<T>> &&
+                    ::std::copyable<value_type<T>>;
+
+template<typename T>
+[[nodiscard]]
+constexpr bool is_null(T const&) noexcept {
+    return false;
+}
+
+template<typename T>
+[[nodiscard]]
+constexpr bool is_null(::std::optional<T> const& value) noexcept {
+    return !value.has_value();
+}
+
+template<typename T>
+[[nodiscard]]
+constexpr T const& value_of(T const& value) noexcept {
+    return value;
+}
+
+template<typename T>
+[[nodiscard]]
+constexpr T const& value_of(::std::optional<T> const& value) noexcept {
+    return *value;
+}
+
+}  // namespace details::zone
+
+/* statistics of a block of `details::zone::block_rows` rows of a column,
+ * `min` and `max` are meaningless if the block is all null
+ */
+template<typename T>
+struct Zone {
+    T min;
+    T max;
+    ::std::size_t nulls;
+};
+
+namespace details {
+
+struct column_access;
+
+}  // namespace details
+
+/* a column of a Table
+ *
+ * columns of ordered types keep a Zone per block, updated on every append and every `set`.
+ * values are only written through `push_back` and `set`, so the zones never miss a value.
+ */
+template<typename T>
+struct Column {
+    using value_type = T;
+    static constexpr bool has_zones{details::zone::has_zones<T>};
+
+    [[nodiscard]]
+    ::std::size_t size() const noexcept {
+        return this->values_.size();
+    }
+
+    [[nodiscard]]
+    ::std::vector<Zone<details::zone::value_type<T>>> const& zones() const noexcept {
+        return this->zones_;
+    }
+
+    void reserve(::std::size_t const n) {
+        this->values_.reserve(n);
+    }
+
+    void push_back(T const& value) {
+        this->values_.push_back(value);
+        if constexpr (has_zones) {
+            try {
+                this->update_zone(this->values_.size() - 1);
+            } catch (...) {
+                this->pop_back();
+                throw;
+            }
+        }
+    }
+
+    void pop_back() {
+        assert(!this->values_.empty());
+        this->values_.pop_back();
+        if constexpr (has_zones) {
+            // the value may have widened the zone of its block, so the block is summarized again
+            auto const first = this->values_.size() / details::zone::block_rows * details::zone::block_rows;
+            this->zones_.resize(first / details::zone::block_rows);
+            for (auto i = first; i < this->values_.size(); ++i) {
+                this->update_zone(i);
+            }
+        }
+    }
+
+    /* overwrite a value, its zone is widened to cover it, but not narrowed
+     * for the value it replaces, call `rebuild_zones()` to make zones tight again
+     */
+    void set(::std::size_t const index, T const& value) {
+        assert(index < this->values_.size());
+        if constexpr (has_zones) {
+            auto& zone = this->zones_[index / details::zone::block_rows];
+            auto const first = index / details::zone::block_rows * details::zone::block_rows;
+            auto const all_null = zone.nulls == ::std::min(this->values_.size() - first, details::zone::block_rows);
+            zone.nulls -= details::zone::is_null(this->values_[index]);
+            this->values_[index] = value;
+            if (details::zone::is_null(value)) {
+                ++zone.nulls;
+            } else if (all_null) {
+                zone.min = details::zone::value_of(value);
+                zone.max = details::zone::value_of(value);
+            } else {
+                zone.min = ::std::min(zone.min, details::zone::value_of(value));
+                zone.max = ::std::max(zone.max, details::zone::value_of(value));
+            }
+        } else {
+            this->values_[index] = value;
+        }
+    }
+
+    void rebuild_zones() {
+        if constexpr (has_zones) {
+            this->zones_.clear();
+            for (::std::size_t i{}; i < this->values_.size(); ++i) {
+                this->update_zone(i);
+            }
+        }
+    }
+
+    [[nodiscard]]
+    T const& operator[](::std::size_t const index) const noexcept {
+        assert(index < this->values_.size());
+        return this->values_[index];
+    }
+
+    [[nodiscard]]
+    auto begin() const noexcept {
+        return this->values_.begin();
+    }
+
+    [[nodiscard]]
+    auto end() const noexcept {
+        return this->values_.end();
+    }
+
+private:
+    friend struct details::column_access;
+
+    ::std::vector<T> values_;
+    ::std::vector<Zone<details::zone::value_type<T>>> zones_;
+
+    void update_zone(::std::size_t const index) {
+        auto const row = index % details::zone::block_rows;
+        if (row == 0) {
+            this->zones_.emplace_back();
+        }
+        auto& zone = this->zones_.back();
+        auto const& value = this->values_[index];
+        if (details::zone::is_null(value)) {
+            ++zone.nulls;
+        } else if (row == zone.nulls) {  // first value of the block
+            zone.min = details::zone::value_of(value);
+            zone.max = details::zone::value_of(value);
+        } else {
+            zone.min = ::std::min(zone.min, details::zone::value_of(value));
+            zone.max = ::std::max(zone.max, details::zone::value_of(value));
+        }
+    }
+};
+
+/* a dictionary-encoded column of strings
+ *
+ * every row is a code, 32-bit by default, and each distinct string is stored once in an arena.
+ * `operator[]` returns a view into the arena, which is invalidated by `push_back`.
+ * rows are only written through `push_back`, so the codes, the arena and the lookup table agree.
+ */
+template<string::is_char Char, ::std::unsigned_integral Code = ::std::uint32_t>
+struct DictionaryColumn {
+    using code_type = Code;
+    using view_type = ::std::basic_string_view<Char>;
+    static constexpr bool has_zones{false};
+
+    [[nodiscard]]
+    ::std::size_t size() const noexcept {
+        return this->codes_.size();
+    }
+
+    /* the number of distinct strings, codes are 0 .. distinct()
+     */
+    [[nodiscard]]
+    ::std::size_t distinct() const noexcept {
+        return this->offsets_.size() - 1;
+    }
+
+    /* the code of every row
+     */
+    [[nodiscard]]
+    ::std::vector<code_type> const& codes() const noexcept {
+        return this->codes_;
+    }
+
+    void reserve(::std::size_t const n) {
+        this->codes_.reserve(n);
+    }
+
+    void push_back(view_type const value) {
+        auto code = this->find(value);
+        if (!code.has_value()) {
+            // slots hold `code + 1`, so the largest code_type is not a code
+            if (this->distinct() >= ::std::numeric_limits<code_type>::max()) {
+                throw ::std::length_error{"ctb::namedtuple::DictionaryColumn: too many distinct strings"};
+            }
+            code = static_cast<code_type>(this->distinct());
+            this->arena_.insert(this->arena_.end(), value.begin(), value.end());
+            try {
+                this->offsets_.push_back(this->arena_.size());
+                this->insert_slot(*code);
+            } catch (...) {
+                this->offsets_.resize(*code + 1);
+                this->arena_.resize(this->offsets_.back());
+                throw;
+            }
+        }
+        this->codes_.push_back(*code);
+    }
+
+    /* remove the last row, the string it held stays in the dictionary
+     */
+    void pop_back() noexcept {
+        assert(!this->codes_.empty());
+        this->codes_.pop_back();
+    }
+
+    void rebuild_zones() noexcept {
+    }
+
+    /* the code of `value`, if any row holds it
+     */
+    [[nodiscard]]
+    ::std::optional<code_type> find(view_type const value) const noexcept {
+        if (this->slots_.empty()) {
+            return ::std::nullopt;
+        }
+        auto const mask = this->slots_.size() - 1;
+        for (auto slot = ::std::hash<view_type>{}(value) & mask;; slot = (slot + 1) & mask) {
+            if (this->slots_[slot] == 0) {
+                return ::std::nullopt;
+            }
+            auto const code = static_cast<code_type>(this->slots_[slot] - 1);
+            if (this->decode(code) == value) {
+                return code;
+            }
+        }
+    }
+
+    [[nodiscard]]
+    view_type decode(code_type const code) const noexcept {
+        assert(code < this->distinct());
+        return view_type{this->arena_.data() + this->offsets_[code], this->offsets_[code + 1] - this->offsets_[code]};
+    }
+
+    [[nodiscard]]
+    view_type operator[](::std::size_t const index) const noexcept {
+        assert(index < this->codes_.size());
+        return this->decode(this->codes_[index]);
+    }
+
+private:
+    ::std::vector<code_type> codes_;
+    ::std::vector<Char> arena_;
+    // offsets_[code] .. offsets_[code + 1] is the string of `code` in the arena
+    ::std::vector<::std::size_t> offsets_{0};
+    // open addressing table of `code + 1`, 0 is an empty slot
+    ::std::vector<code_type> slots_;
+
+    void insert_slot(code_type const code) {
+        if (2 * this->distinct() > this->slots_.size()) {
+            this->slots_.assign(::std::max<::std::size_t>(this->slots_.size() * 2, 16), 0);
+            for (::std::size_t i{}; i + 1 < this->distinct(); ++i) {
+                this->place(static_cast<code_type>(i));
+            }
+        }
+        this->place(code);
+    }
+
+    void place(code_type const code) noexcept {
+        auto const mask = this->slots_.size() - 1;
+        auto slot = ::std::hash<view_type>{}(this->decode(code)) & mask;
+        while (this->slots_[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        this->slots_[slot] = static_cast<code_type>(code + 1);
+    }
+};
+
+/* string columns are dictionary-encoded
+ */
+template<string::is_char Char>
+struct Column<::std::basic_string<Char>> : DictionaryColumn<Char> {
+    using value_type = ::std::basic_string<Char>;
+};
+
+template<string::is_char Char>
+struct Column<::std::basic_string_view<Char>> : DictionaryColumn<Char> {
+    using value_type = ::std::basic_string_view<Char>;
+};
+
+namespace details {
+
+/* writes into a column that bypass its zones, for the parallel algorithms
+ * which rebuild the zones of every column they wrote once they are done
+ */
+struct column_access {
+    template<typename T>
+    [[nodiscard]]
+    static T* data(Column<T>& col) noexcept {
+        return col.values_.data();
+    }
+};
+
+template<typename>
+constexpr bool is_dictionary_ = false;
+
+template<string::is_char Char, ::std::unsigned_integral Code>
+constexpr bool is_dictionary_<DictionaryColumn<Char, Code>> = true;
+
+template<string::is_char Char>
+constexpr bool is_dictionary_<Column<::std::basic_string<Char>>> = true;
+
+template<string::is_char Char>
+constexpr bool is_dictionary_<Column<::std::basic_string_view<Char>>> = true;
+
+template<typename T>
+concept is_dictionary = is_dictionary_<::std::remove_cvref_t<T>>;
+
+}  // namespace details
+
+/* columnar storage of namedtuples: every field is kept in its own Column
+ *
+ * Usage:
+ *   auto table = Table<names<"ts", "value">, long, double>{};
+ *   table.push_back(make_namedtuple<"ts", "value">(1l, 0.5));
+ *   get<"value">(table.columns)[0] == 0.5
+ */
+template<details::is_names Names, typename... Args>
+    requires (details::get_size<Names>() == sizeof...(Args))
+struct Table {
+    using names = Names;
+    using row_type = NamedTuple<Names, Args...>;
+    NamedTuple<Names, Column<Args>...> columns;
+
+    // clang-format off
+    Table() noexcept
+        : columns{Column<Args>{}...}
+    {}
+
+    // clang-format on
+
+    [[nodiscard]]
+    ::std::size_t size() const noexcept {
+        return get<0>(this->columns).size();
+    }
+
+    void reserve(::std::size_t const n) {
+        [&]<::std::size_t... I>(::std::index_sequence<I...>) {
+            (get<I>(this->columns).reserve(n), ...);
+        }(::std::index_sequence_for<Args...>{});
+    }
+
+    /* append a row, if a column throws the columns appended before it are rolled back,
+     * so every column keeps the same number of rows
+     */
+    void push_back(row_type const& row) {
+        ::std::size_t pushed{};
+        try {
+            [&]<::std::size_t... I>(::std::index_sequence<I...>) {
+                ((get<I>(this->columns).push_back(get<I>(row)), ++pushed), ...);
+            }(::std::index_sequence_for<Args...>{});
+        } catch (...) {
+            [&]<::std::size_t... I>(::std::index_sequence<I...>) {
+                ((I < pushed ? get<I>(this->columns).pop_back() : void()), ...);
+            }(::std::index_sequence_for<Args...>{});
+            throw;
+        }
+    }
+};
+
+/* a table over the columns of another table, which it borrows rather than copies
+ *
+ * it is made by `rename` and `project`, and must not outlive the table it borrows from.
+ * it has a fixed number of rows, but its values can be written.
+ */
+template<details::is_names Names, typename... Args>
+    requires (details::get_size<Names>() == sizeof...(Args))
+struct TableView {
+    using names = Names;
+    using row_type = NamedTuple<Names, Args...>;
+    NamedTuple<Names, Column<Args>*...> columns;
+
+    [[nodiscard]]
+    ::std::size_t size() const noexcept {
+        return get<0>(this->columns)->size();
+    }
+};
+
+template<typename>
+struct table_of_;
+
+template<details::is_names Names, typename... Args>
+struct table_of_<NamedTuple<Names, Args...>> {
+    using type = Table<Names, Args...>;
+};
+
+/* the Table that stores rows of the namedtuple `NT`
+ */
+template<is_namedtuple NT>
+using table_of = typename table_of_<::std::remove_cvref_t<NT>>::type;
+
+/* the Table that stores rows of the nested namedtuple `NT` shredded into a column per leaf,
+ * the columns are named by path, like "request.headers.host"
+ *
+ * Usage: shredded_table_of<event>{}.push_back(flatten(event))
+ */
+template<is_namedtuple NT>
+using shredded_table_of = table_of<flattened_t<NT>>;
+
+namespace details {
+
+template<typename>
+constexpr bool is_table_ = false;
+
+template<is_names Names, typename... Args>
+constexpr bool is_table_<Table<Names, Args...>> = true;
+
+template<is_names Names, typename... Args>
+constexpr bool is_table_<TableView<Names, Args...>> = true;
+
+template<typename>
+constexpr bool is_table_view_ = false;
+
+template<is_names Names, typename... Args>
+constexpr bool is_table_view_<TableView<Names, Args...>> = true;
+
+template<typename T>
+concept is_table_view = is_table_view_<::std::remove_cvref_t<T>>;
+
+}  // namespace details
+
+/* a Table or a TableView
+ */
+template<typename T>
+concept is_table = details::is_table_<::std::remove_cvref_t<T>>;
+
+/* get a column of a table by index
+ *
+ * Usage: column<0>(table)
+ */
+template<::std::size_t I, is_table T>
+[[nodiscard]]
+constexpr auto column(T&& table) noexcept -> decltype(auto) {
+    if constexpr (details::is_table_view<T>) {
+        return *get<I>(table.columns);
+    } else {
+        return get<I>(::std::forward<T>(table).columns);
+    }
+}
+
+/* get a column of a table by name
+ *
+ * Usage: column<"ts">(table)
+ */
+template<string::String str, is_table T>
+[[nodiscard]]
+constexpr auto column(T&& table) noexcept -> decltype(auto) {
+    return column<details::get_index<str, typename ::std::remove_cvref_t<T>::names>()>(::std::forward<T>(table));
+}
+
+namespace details::view {
+
+template<auto Key, string::String Old, string::String New>
+[[nodiscard]]
+consteval auto rename_key() noexcept {
+    if constexpr (Key == key_of<Old>) {
+        return key_of<New>;
+    } else {
+        return Key;
+    }
+}
+
+template<typename Names, string::String Old, string::String New>
+struct rename_;
+
+template<auto... Keys, string::String Old, string::String New>
+struct rename_<names<Keys...>, Old, New> {
+    using type = names<rename_key<Keys, Old, New>()...>;
+};
+
+/* what a view can borrow from: a table the caller keeps, or any view, even a temporary one
+ * since its columns belong to the table under it
+ */
+template<typename T>
+concept borrowable =
+    is_table_view<T> || (::std::is_lvalue_reference_v<T> && !::std::is_const_v<::std::remove_reference_t<T>>);
+
+/* a view of the columns `I...` of `table`, named `Names`
+ */
+template<is_names Names, ::std::size_t... I, typename T>
+[[nodiscard]]
+auto borrow(T& table) noexcept {
+    using row_type = typename ::std::remove_const_t<T>::row_type;
+    return TableView<Names, ::std::tuple_element_t<I, row_type>...>{
+        NamedTuple<Names, Column<::std::tuple_element_t<I, row_type>>*...>{&column<I>(table)...}};
+}
+
+}  // namespace details::view
+
+/* a view of `table` with the column `Old` named `New`, the columns are not copied
+ *
+ * Usage: auto view = rename<"ts", "timestamp">(table);
+ */
+template<string::String Old, string::String New, is_table T>
+    requires (details::view::borrowable<T>)
+[[nodiscard]]
+auto rename(T&& table) noexcept {
+    using names_ = typename ::std::remove_cvref_t<T>::names;
+    static_assert(details::get_index_<Old, names_>::find() < details::get_size<names_>(),
+                  "ctb::namedtuple::rename: name not found");
+    return [&]<::std::size_t... I>(::std::index_sequence<I...>) {
+        return details::view::borrow<typename details::view::rename_<names_, Old, New>::type, I...>(table);
+    }(::std::make_index_sequence<details::get_size<names_>()>{});
+}
+
+/* a view of the columns `Strs...` of `table`, in that order, the columns are not copied
+ *
+ * Usage: auto view = project<"price", "qty">(rename<"ts", "timestamp">(table));
+ */
+template<string::String... Strs, is_table T>
+    requires (sizeof...(Strs) > 0 && details::view::borrowable<T>)
+[[nodiscard]]
+auto project(T&& table) noexcept {
+    using names_ = typename ::std::remove_cvref_t<T>::names;
+    return details::view::borrow<names<Strs...>, details::get_index<Strs, names_>()...>(table);
+}
+
+/* a row of a table, fields are read from their columns only when accessed
+ *
+ * fields are read-only, except the columns `Writable...`, which `parallel_for_each` hands out
+ * as references and rebuilds the zones of afterwards. use `set` to write any other field.
+ */
+template<typename TableT, string::String... Writable>
+struct RowRef {
+    TableT* table;
+    ::std::size_t index;
+};
+
+template<string::String str, typename TableT, string::String... Writable>
+[[nodiscard]]
+constexpr auto get(RowRef<TableT, Writable...> const row) noexcept -> decltype(auto) {
+    if constexpr (((str == Writable) || ...)) {
+        return details::column_access::data(column<str>(*row.table))[row.index];
+    } else {
+        return ::std::as_const(column<str>(*row.table))[row.index];
+    }
+}
+
+/* write a field of a row, the zones of its column are kept up to date
+ *
+ * Usage: for_each_equal<"status">(table, "ERROR", [](auto row) { set<"retries">(row, 0); });
+ */
+template<string::String str, typename TableT, typename V>
+    requires (!::std::is_const_v<TableT>)
+void set(RowRef<TableT> const row, V const& value) {
+    column<str>(*row.table).set(row.index, value);
+}
+
+namespace details::parallel {
+
+/* rows of a chunk: the fields of its rows take about 256KiB, to stay in L2 cache, but a chunk
+ * has at least 64 rows however wide they are. it is a multiple of 64 rows, so chunks split every
+ * column at a multiple of 64 bytes from its start, and two chunks share at most the cache line
+ * of their boundary, when the column is not 64-byte aligned.
+ */
+template<typename... Args>
+constexpr ::std::size_t chunk_rows = ::std::max<::std::size_t>(256 * 1024 / (sizeof(Args) + ...) / 64, 1) * 64;
+
+/* run `func(chunk)` for every chunk in [0, chunks)
+ *
+ * workers claim the next chunk from a shared counter as soon as they finish
+ * one, so a slow chunk doesn't hold up the others.
+ * `threads == 0` means one thread per hardware thread, they are started on every call.
+ * if `func` throws, no further chunk is claimed, and the first exception is rethrown
+ * on the calling thread once every worker has stopped.
+ */
+template<typename Func>
+void for_chunks(::std::size_t const chunks, ::std::size_t threads, Func const& func) {
+    if (threads == 0) {
+        threads = ::std::max(::std::thread::hardware_concurrency(), 1u);
+    }
+    threads = ::std::min(threads, chunks);
+    if (threads <= 1) {
+        for (::std::size_t chunk{}; chunk < chunks; ++chunk) {
+            func(chunk);
+        }
+        return;
+    }
+
+    auto next = ::std::atomic<::std::size_t>{};
+    auto failed = ::std::atomic<bool>{};
+    auto failure = ::std::exception_ptr{};
+    auto const worker = [&]() noexcept {
+        try {
+            for (auto chunk = next.fetch_add(1, ::std::memory_order_relaxed); chunk < chunks;
+                 chunk = next.fetch_add(1, ::std::memory_order_relaxed)) {
+                func(chunk);
+            }
+        } catch (...) {
+            // the first failure is kept, joining the workers publishes it to the caller
+            if (!failed.exchange(true, ::std::memory_order_relaxed)) {
+                failure = ::std::current_exception();
+            }
+            next.store(chunks, ::std::memory_order_relaxed);
+        }
+    };
+
+    {
+        auto pool = ::std::vector<::std::jthread>{};
+        pool.reserve(threads - 1);
+        for (::std::size_t i{1}; i < threads; ++i) {
+            pool.emplace_back(worker);
+        }
+        worker();
+    }
+    if (failure) {
+        ::std::rethrow_exception(failure);
+    }
+}
+
+template<typename Row>
+constexpr ::std::size_t chunk_rows_of = 0;
+
+template<is_names Names, typename... Args>
+constexpr ::std::size_t chunk_rows_of<NamedTuple<Names, Args...>> = chunk_rows<Args...>;
+
+template<typename T, typename Func>
+void for_rows(T const&, ::std::size_t const size, ::std::size_t const threads, Func const& func) {
+    constexpr auto rows = chunk_rows_of<typename T::row_type>;
+    for_chunks((size + rows - 1) / rows, threads, [&](::std::size_t const chunk) {
+        auto const last = ::std::min(size, (chunk + 1) * rows);
+        for (auto i = chunk * rows; i < last; ++i) {
+            func(i);
+        }
+    });
+}
+
+}  // namespace details::parallel
+
+/* compute the column `Out` from every row, on `threads` threads
+ * (0: one per hardware thread), in cache-sized chunks of rows
+ *
+ * the threads are created and joined on every call, which costs tens of microseconds,
+ * so small tables are better served by `threads = 1`, which runs on the calling thread.
+ *
+ * `func` gets a read-only RowRef, columns it doesn't `get` are never touched.
+ *
+ * Usage: parallel_transform<"total">(table, [](auto row) { return get<"price">(row) * get<"qty">(row); });
+ */
+template<string::String Out, is_table T, typename Func>
+void parallel_transform(T& table, Func const& func, ::std::size_t const threads = 0) {
+    auto& out = column<Out>(table);
+    static_assert(!::std::is_same_v<typename ::std::remove_cvref_t<decltype(out)>::value_type, bool>,
+                  "ctb::namedtuple::parallel_transform: elements of a bool column can't be written concurrently");
+    static_assert(!details::is_dictionary<decltype(out)>,
+                  "ctb::namedtuple::parallel_transform: a dictionary-encoded column can't be written in place");
+
+    auto const& view = table;
+    auto* const data = details::column_access::data(out);
+    try {
+        details::parallel::for_rows(view, view.size(), threads, [&](::std::size_t const i) {
+            data[i] = func(RowRef<T const>{&view, i});
+        });
+    } catch (...) {
+        out.rebuild_zones();
+        throw;
+    }
+    out.rebuild_zones();
+}
+
+/* call `func` for every row, on `threads` threads (0: one per hardware thread),
+ * in cache-sized chunks of rows
+ *
+ * rows are read-only but for the columns `Out...`, whose zones are rebuilt afterwards,
+ * even when `func` throws. like `parallel_transform`, the threads are created and joined
+ * on every call, and the first exception thrown by `func` is rethrown once they are.
+ *
+ * Usage: parallel_for_each<"value">(table, [](auto row) { get<"value">(row) *= 2; });
+ */
+template<string::String... Out, is_table T, typename Func>
+void parallel_for_each(T& table, Func const& func, ::std::size_t const threads = 0) {
+    if constexpr (sizeof...(Out) == 0) {
+        details::parallel::for_rows(table, table.size(), threads, [&](::std::size_t const i) {
+            func(RowRef<T const>{&table, i});
+        });
+    } else {
+        static_assert(!::std::is_const_v<T>, "ctb::namedtuple::parallel_for_each: table is const");
+        static_assert(
+            (!::std::is_same_v<typename ::std::remove_cvref_t<decltype(column<Out>(table))>::value_type, bool> && ...),
+            "ctb::namedtuple::parallel_for_each: elements of a bool column can't be written concurrently");
+        static_assert((!details::is_dictionary<decltype(column<Out>(table))> && ...),
+                      "ctb::namedtuple::parallel_for_each: a dictionary-encoded column can't be written in place");
+
+        try {
+            details::parallel::for_rows(table, table.size(), threads, [&](::std::size_t const i) {
+                func(RowRef<T, Out...>{&table, i});
+            });
+        } catch (...) {
+            (column<Out>(table).rebuild_zones(), ...);
+            throw;
+        }
+        (column<Out>(table).rebuild_zones(), ...);
+    }
+}
+
+/* call `func` for every row whose `Name` is in [lo, hi], null never matches
+ * blocks whose Zone can't contain such a value are skipped without reading them
+ *
+ * Usage: for_each_between<"ts">(table, begin, end, [](auto row) { ... });
+ */
+template<string::String Name, is_table T, typename V, typename Func>
+void for_each_between(T& table, V const& lo, V const& hi, Func&& func) {
+    auto const& col = column<Name>(table);
+    static_assert(::std::remove_cvref_t<decltype(col)>::has_zones,
+                  "ctb::namedtuple::for_each_between: column is not ordered");
+
+    for (::std::size_t block{}; block < col.zones().size(); ++block) {
+        auto const& zone = col.zones()[block];
+        auto const first = block * details::zone::block_rows;
+        auto const last = ::std::min(first + details::zone::block_rows, col.size());
+        if (zone.nulls == last - first || zone.max < lo || hi < zone.min) {
+            continue;
+        }
+        for (auto i = first; i < last; ++i) {
+            auto const& value = col[i];
+            if (!details::zone::is_null(value) && !(details::zone::value_of(value) < lo) &&
+                !(hi < details::zone::value_of(value))) {
+                func(RowRef<T>{&table, i});
+            }
+        }
+    }
+}
+
+/* call `func` for every row whose `Name` equals `value`
+ * on a dictionary-encoded column `value` is resolved to its code once,
+ * and rows are matched by comparing codes
+ *
+ * Usage: for_each_equal<"status">(table, "OK", [](auto row) { ... });
+ */
+template<string::String Name, is_table T, typename V, typename Func>
+void for_each_equal(T& table, V const& value, Func&& func) {
+    auto const& col = column<Name>(table);
+    if constexpr (details::is_dictionary<decltype(col)>) {
+        auto const code = col.find(value);
+        if (!code.has_value()) {
+            return;
+        }
+        for (::std::size_t i{}; i < col.size(); ++i) {
+            if (col.codes()[i] == *code) {
+                func(RowRef<T>{&table, i});
+            }
+        }
+    } else {
+        for (::std::size_t i{}; i < col.size(); ++i) {
+            if (col[i] == value) {
+                func(RowRef<T>{&table, i});
+            }
+        }
+    }
+}
+
+/* count the rows of every distinct string of a dictionary-encoded column,
+ * the result is indexed by code, see `DictionaryColumn::decode`
+ *
+ * Usage: auto counts = count_by<"region">(table);
+ */
+template<string::String Name, is_table T>
+[[nodiscard]]
+::std::vector<::std::size_t> count_by(T const& table) {
+    auto const& col = column<Name>(table);
+    static_assert(details::is_dictionary<decltype(col)>, "ctb::namedtuple::count_by: column is not dictionary-encoded");
+
+    auto counts = ::std::vector<::std::size_t>(col.distinct());
+    for (auto const code : col.codes()) {
+        ++counts[code];
+    }
+    return counts;
+}
+
+}  // namespace ctb::namedtuple
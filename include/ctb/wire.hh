@@ -0,0 +1,347 @@
+#pragma once
+
+#if !__cpp_concepts >= 201907L
+    #error "wire requires at least c++20"
+#endif
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "codec.hh"
+#include "namedtuple.hh"
+
+namespace ctb::namedtuple::details::wire {
+
+/* the wire types of protobuf, field I is tagged with (I + 1) << 3 | wire type
+ */
+enum class wire_type : ::std::uint8_t {
+    varint = 0,
+    fixed64 = 1,
+    length_delimited = 2,
+    fixed32 = 5,
+};
+
+template<typename T>
+concept is_varint = ::std::is_integral_v<T> || ::std::is_enum_v<T>;
+
+/* the encoder of a field is picked from its type:
+ *   bool, integers, enums  -> varint, signed integers zigzag encoded, enums sign extended like protobuf enums
+ *   float, double          -> fixed32, fixed64, little endian
+ *   String<char>, string   -> length delimited, up to the first '\0' for String
+ *   namedtuple             -> length delimited, a nested message
+ */
+template<typename T>
+[[nodiscard]]
+consteval wire_type wire_type_of() noexcept {
+    if constexpr (is_varint<T>) {
+        return wire_type::varint;
+    } else if constexpr (::std::is_same_v<T, float>) {
+        return wire_type::fixed32;
+    } else if constexpr (::std::is_same_v<T, double>) {
+        return wire_type::fixed64;
+    } else if constexpr (codec::is_std_string_<T> || is_namedtuple<T>) {
+        return wire_type::length_delimited;
+    } else if constexpr (string::is_ctb_string<T>) {
+        static_assert(::std::is_same_v<typename T::value_type, char>, "only char Strings can be encoded");
+        return wire_type::length_delimited;
+    } else {
+        static_assert(!sizeof(T), "this type has no wire encoding");
+    }
+}
+
+[[nodiscard]]
+constexpr ::std::uint64_t zigzag(::std::int64_t const value) noexcept {
+    return static_cast<::std::uint64_t>(value) << 1 ^ static_cast<::std::uint64_t>(value >> 63);
+}
+
+[[nodiscard]]
+constexpr ::std::int64_t unzigzag(::std::uint64_t const value) noexcept {
+    return static_cast<::std::int64_t>(value >> 1 ^ (~(value & 1) + 1));
+}
+
+constexpr ::std::size_t max_varint_size{10};
+
+/* LEB128, returns the number of bytes written to `out`
+ */
+constexpr ::std::size_t put_varint(::std::uint64_t value, ::std::byte* const out) noexcept {
+    ::std::size_t size{};
+    for (; value >= 0x80; value >>= 7) {
+        out[size++] = static_cast<::std::byte>(value & 0x7f | 0x80);
+    }
+    out[size++] = static_cast<::std::byte>(value);
+    return size;
+}
+
+/* the reading side of a message, every read fails once the input is exhausted or malformed
+ */
+struct reader : codec::byte_reader {
+    [[nodiscard]]
+    constexpr bool varint(::std::uint64_t& value) noexcept {
+        value = 0;
+        for (unsigned shift{}; shift < 64; shift += 7) {
+            ::std::uint8_t byte;
+            if (!this->byte(byte)) {
+                return false;
+            }
+            value |= (::std::uint64_t{byte} & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                // the 10th byte may only carry the last bit
+                return shift != 63 || byte <= 1;
+            }
+        }
+        return false;
+    }
+
+    template<typename U>
+    [[nodiscard]]
+    constexpr bool fixed(U& value) noexcept {
+        if (this->remaining() < sizeof(U)) {
+            return false;
+        }
+        value = 0;
+        for (::std::size_t i{}; i < sizeof(U); ++i) {
+            value |= static_cast<U>(static_cast<U>(*this->it++) << i * 8);
+        }
+        return true;
+    }
+
+    /* the next `size` bytes as a reader of their own
+     */
+    [[nodiscard]]
+    constexpr bool sub(reader& res) noexcept {
+        ::std::uint64_t size;
+        if (!this->varint(size) || size > this->remaining()) {
+            return false;
+        }
+        res = reader{{this->it, this->it + size}};
+        this->it += size;
+        return true;
+    }
+
+    [[nodiscard]]
+    constexpr bool skip(wire_type const type) noexcept {
+        ::std::uint64_t ignored;
+        reader sub_reader;
+        switch (type) {
+        case wire_type::varint:
+            return this->varint(ignored);
+        case wire_type::fixed64:
+            return this->fixed(ignored);
+        case wire_type::fixed32: {
+            ::std::uint32_t ignored32;
+            return this->fixed(ignored32);
+        }
+        case wire_type::length_delimited:
+            return this->sub(sub_reader);
+        default:
+            return false;
+        }
+    }
+};
+
+template<typename NT>
+void encode(NT const& nt, ::std::vector<::std::byte>& out);
+
+inline void put_varint(::std::uint64_t const value, ::std::vector<::std::byte>& out) {
+    ::std::byte bytes[max_varint_size];
+    out.insert(out.end(), bytes, bytes + put_varint(value, bytes));
+}
+
+template<typename U>
+void put_fixed(U const value, ::std::vector<::std::byte>& out) {
+    for (::std::size_t i{}; i < sizeof(U); ++i) {
+        out.push_back(static_cast<::std::byte>(value >> i * 8 & 0xff));
+    }
+}
+
+template<typename T>
+void put_value(T const& value, ::std::vector<::std::byte>& out) {
+    if constexpr (::std::is_same_v<T, bool>) {
+        out.push_back(static_cast<::std::byte>(value));
+    } else if constexpr (::std::is_enum_v<T>) {
+        // protobuf writes enums as int32, a negative value is sign extended to 10 bytes
+        using underlying_type = ::std::underlying_type_t<T>;
+        using wide_type = ::std::conditional_t<::std::is_signed_v<underlying_type>, ::std::int64_t, ::std::uint64_t>;
+        put_varint(static_cast<::std::uint64_t>(static_cast<wide_type>(value)), out);
+    } else if constexpr (::std::is_integral_v<T> && ::std::is_signed_v<T>) {
+        put_varint(zigzag(value), out);
+    } else if constexpr (::std::is_integral_v<T>) {
+        put_varint(value, out);
+    } else if constexpr (::std::is_same_v<T, float>) {
+        put_fixed(::std::bit_cast<::std::uint32_t>(value), out);
+    } else if constexpr (::std::is_same_v<T, double>) {
+        put_fixed(::std::bit_cast<::std::uint64_t>(value), out);
+    } else if constexpr (codec::is_std_string_<T>) {
+        put_varint(value.size(), out);
+        auto const* const bytes = reinterpret_cast<::std::byte const*>(value.data());
+        out.insert(out.end(), bytes, bytes + value.size());
+    } else if constexpr (string::is_ctb_string<T>) {
+        auto const size = codec::str_length(value);
+        put_varint(size, out);
+        auto const* const bytes = reinterpret_cast<::std::byte const*>(value.str.arr);
+        out.insert(out.end(), bytes, bytes + size);
+    } else {
+        // nested messages are written after a placeholder for their length, which
+        // isn't known yet; the payload is shifted if the length takes more than one byte
+        auto const begin = out.size();
+        out.push_back(::std::byte{});
+        encode(value, out);
+        auto const size = out.size() - begin - 1;
+        ::std::byte bytes[max_varint_size];
+        auto const length = put_varint(size, bytes);
+        out.insert(out.begin() + static_cast<::std::ptrdiff_t>(begin), bytes, bytes + length - 1);
+        ::std::copy(bytes, bytes + length, out.begin() + static_cast<::std::ptrdiff_t>(begin));
+    }
+}
+
+template<typename NT>
+[[nodiscard]]
+bool decode(NT& nt, reader in);
+
+template<typename T>
+[[nodiscard]]
+bool get_value(T& value, reader& in) {
+    if constexpr (::std::is_enum_v<T>) {
+        using underlying_type = ::std::underlying_type_t<T>;
+        ::std::uint64_t raw;
+        if (!in.varint(raw)) {
+            return false;
+        }
+        auto const underlying = static_cast<underlying_type>(raw);
+        value = static_cast<T>(underlying);
+        if constexpr (::std::is_signed_v<underlying_type>) {
+            return underlying == static_cast<::std::int64_t>(raw);
+        } else {
+            return underlying == raw;
+        }
+    } else if constexpr (::std::is_integral_v<T>) {
+        ::std::uint64_t raw;
+        if (!in.varint(raw)) {
+            return false;
+        }
+        if constexpr (::std::is_same_v<T, bool>) {
+            value = raw != 0;
+            return raw <= 1;
+        } else if constexpr (::std::is_signed_v<T>) {
+            auto const wide = unzigzag(raw);
+            value = static_cast<T>(wide);
+            return value == wide;
+        } else {
+            value = static_cast<T>(raw);
+            return static_cast<::std::uint64_t>(value) == raw;
+        }
+    } else if constexpr (::std::is_same_v<T, float>) {
+        ::std::uint32_t raw;
+        if (!in.fixed(raw)) {
+            return false;
+        }
+        value = ::std::bit_cast<float>(raw);
+        return true;
+    } else if constexpr (::std::is_same_v<T, double>) {
+        ::std::uint64_t raw;
+        if (!in.fixed(raw)) {
+            return false;
+        }
+        value = ::std::bit_cast<double>(raw);
+        return true;
+    } else {
+        reader bytes;
+        if (!in.sub(bytes)) {
+            return false;
+        }
+        if constexpr (codec::is_std_string_<T>) {
+            value.assign(reinterpret_cast<char const*>(bytes.it), bytes.remaining());
+            return true;
+        } else if constexpr (string::is_ctb_string<T>) {
+            return codec::assign_str(value, reinterpret_cast<char const*>(bytes.it), bytes.remaining());
+        } else {
+            return decode(value, bytes);
+        }
+    }
+}
+
+template<::std::size_t I, typename NT>
+void encode_field(NT const& nt, ::std::vector<::std::byte>& out) {
+    using field_type = ::std::remove_cvref_t<decltype(get<I>(nt))>;
+    constexpr auto tag = (I + 1) << 3 | static_cast<::std::size_t>(wire_type_of<field_type>());
+    put_varint(tag, out);
+    put_value(get<I>(nt), out);
+}
+
+template<typename NT>
+void encode(NT const& nt, ::std::vector<::std::byte>& out) {
+    [&]<::std::size_t... I>(::std::index_sequence<I...>) {
+        (encode_field<I>(nt, out), ...);
+    }(::std::make_index_sequence<::std::tuple_size_v<NT>>{});
+}
+
+template<::std::size_t I, typename NT>
+[[nodiscard]]
+bool decode_field(NT& nt, wire_type const type, reader& in) {
+    using field_type = ::std::remove_cvref_t<decltype(get<I>(nt))>;
+    return type == wire_type_of<field_type>() && get_value(get<I>(nt), in);
+}
+
+/* fields missing from the input keep their value, unknown fields are skipped
+ */
+template<typename NT>
+bool decode(NT& nt, reader in) {
+    while (in.it != in.end) {
+        ::std::uint64_t tag;
+        if (!in.varint(tag)) {
+            return false;
+        }
+        auto const field = tag >> 3;
+        auto const type = static_cast<wire_type>(tag & 7);
+        auto ok = true;
+        auto const known = [&]<::std::size_t... I>(::std::index_sequence<I...>) {
+            return ((field == I + 1 && (ok = decode_field<I>(nt, type, in), true)) || ...);
+        }(::std::make_index_sequence<::std::tuple_size_v<NT>>{});
+        if (!ok || !known && !in.skip(type)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace ctb::namedtuple::details::wire
+
+namespace ctb::namedtuple {
+
+/* append the protobuf-style encoding of `nt` to `out`
+ *
+ * field I is tagged as protobuf field I + 1, so a namedtuple can be read by any
+ * protobuf decoder with a matching message (signed integers as sint32/sint64, enums as enums)
+ *
+ * Usage:
+ *   auto bytes = ::std::vector<::std::byte>{};
+ *   encode_wire(nt, bytes);
+ */
+template<is_namedtuple NT>
+void encode_wire(NT const& nt, ::std::vector<::std::byte>& out) {
+    details::wire::encode(nt, out);
+}
+
+/* decode a message written by `encode_wire` into `nt`
+ *
+ * fields missing from the message keep their value, and fields unknown to `NT`
+ * are skipped, so schemas can gain fields at the end. returns false if the
+ * message is malformed, `nt` may then be partially written.
+ *
+ * Usage: if (decode_wire(nt, ::std::span{bytes})) { ... }
+ */
+template<is_namedtuple NT>
+[[nodiscard]]
+bool decode_wire(NT& nt, ::std::span<::std::byte const> const bytes) {
+    return details::wire::decode(nt, details::wire::reader{{bytes.data(), bytes.data() + bytes.size()}});
+}
+
+}  // namespace ctb::namedtuple
@@ -0,0 +1,159 @@
+#pragma once
+
+#if !__cpp_concepts >= 201907L
+    #error "zip requires at least c++20"
+#endif
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "namedtuple.hh"
+
+namespace ctb::namedtuple {
+
+/* an iterator over several ranges at once, its elements are namedtuples of references
+ * to the elements of every range at the same position
+ */
+template<details::is_names Names, ::std::random_access_iterator... Its>
+    requires (details::get_size<Names>() == sizeof...(Its))
+struct ZipIterator {
+    using iterator_concept = ::std::random_access_iterator_tag;
+    // the elements are made on the fly, which a legacy forward iterator can't do
+    using iterator_category = ::std::input_iterator_tag;
+    using value_type = NamedTuple<Names, ::std::iter_value_t<Its>...>;
+    using reference = NamedTuple<Names, ::std::iter_reference_t<Its>...>;
+    using difference_type = ::std::ptrdiff_t;
+
+    ::std::tuple<Its...> its;
+
+    [[nodiscard]]
+    constexpr reference operator*() const noexcept {
+        return ::std::apply(
+            [](auto const&... it) {
+                return reference{*it...};
+            },
+            this->its);
+    }
+
+    [[nodiscard]]
+    constexpr reference operator[](difference_type const n) const noexcept {
+        return *(*this + n);
+    }
+
+    constexpr ZipIterator& operator+=(difference_type const n) noexcept {
+        ::std::apply(
+            [n](auto&... it) {
+                ((it += static_cast<::std::iter_difference_t<decltype(it)>>(n)), ...);
+            },
+            this->its);
+        return *this;
+    }
+
+    constexpr ZipIterator& operator-=(difference_type const n) noexcept {
+        return *this += -n;
+    }
+
+    constexpr ZipIterator& operator++() noexcept {
+        return *this += 1;
+    }
+
+    constexpr ZipIterator operator++(int) noexcept {
+        auto res = *this;
+        ++*this;
+        return res;
+    }
+
+    constexpr ZipIterator& operator--() noexcept {
+        return *this -= 1;
+    }
+
+    constexpr ZipIterator operator--(int) noexcept {
+        auto res = *this;
+        --*this;
+        return res;
+    }
+
+    [[nodiscard]]
+    friend constexpr ZipIterator operator+(ZipIterator it, difference_type const n) noexcept {
+        return it += n;
+    }
+
+    [[nodiscard]]
+    friend constexpr ZipIterator operator+(difference_type const n, ZipIterator it) noexcept {
+        return it += n;
+    }
+
+    [[nodiscard]]
+    friend constexpr ZipIterator operator-(ZipIterator it, difference_type const n) noexcept {
+        return it -= n;
+    }
+
+    // all the iterators move together, so the first one tells the position
+    [[nodiscard]]
+    friend constexpr difference_type operator-(ZipIterator const& lhs, ZipIterator const& rhs) noexcept {
+        return static_cast<difference_type>(::std::get<0>(lhs.its) - ::std::get<0>(rhs.its));
+    }
+
+    [[nodiscard]]
+    friend constexpr bool operator==(ZipIterator const& lhs, ZipIterator const& rhs) noexcept {
+        return ::std::get<0>(lhs.its) == ::std::get<0>(rhs.its);
+    }
+
+    [[nodiscard]]
+    friend constexpr auto operator<=>(ZipIterator const& lhs, ZipIterator const& rhs) noexcept {
+        return ::std::get<0>(lhs.its) <=> ::std::get<0>(rhs.its);
+    }
+};
+
+/* the rows of several columns as a random access range of namedtuples of references,
+ * as long as the shortest column, nothing is copied
+ */
+template<details::is_names Names, ::std::random_access_iterator... Its>
+struct ZipView : ::std::ranges::view_interface<ZipView<Names, Its...>> {
+    using iterator = ZipIterator<Names, Its...>;
+
+    iterator first;
+    ::std::ptrdiff_t count;
+
+    [[nodiscard]]
+    constexpr iterator begin() const noexcept {
+        return this->first;
+    }
+
+    [[nodiscard]]
+    constexpr iterator end() const noexcept {
+        return this->first + this->count;
+    }
+};
+
+/* zip columns into rows named `Str...`, the columns must outlive the view
+ *
+ * Usage:
+ *   for (auto row : zip_named<"ts", "value">(ts, values)) { get<"value">(row) *= 2; }
+ */
+template<string::String... Str, ::std::ranges::random_access_range... Ranges>
+    requires (sizeof...(Str) == sizeof...(Ranges) && sizeof...(Ranges) > 0 &&
+              (::std::ranges::sized_range<Ranges> && ...))
+[[nodiscard]]
+constexpr auto zip_named(Ranges&... ranges) noexcept {
+    using view = ZipView<names<Str...>, ::std::ranges::iterator_t<Ranges>...>;
+    auto const count = ::std::min({static_cast<::std::ptrdiff_t>(::std::ranges::size(ranges))...});
+    return view{{}, typename view::iterator{{::std::ranges::begin(ranges)...}}, count};
+}
+
+}  // namespace ctb::namedtuple
+
+/* a ZipView only holds iterators into the columns
+ */
+namespace std::ranges {
+
+template<::ctb::namedtuple::details::is_names Names, typename... Its>
+constexpr bool enable_borrowed_range<::ctb::namedtuple::ZipView<Names, Its...>> = true;
+
+}  // namespace std::ranges
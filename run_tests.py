@@ -1,4 +1,6 @@
 import os
+import sys
+import time
 import shutil
 import multiprocessing
 
@@ -35,11 +37,42 @@ def test_msvc():
     )
     build_and_run(build_msvc)
 
+def report_hashed_names():
+    """build the tests with and without CTB_N_HASHED_NAMES, print build time and binary size
+
+    CTB_N_HASHED_NAMES is gcc only, so both builds use gcc
+    """
+    for mode in ("OFF", "ON"):
+        build_dir = os.path.join(PROJECT_DIR, f"build-names-{mode.lower()}")
+        if os.system(
+            f"cmake -S {os.path.join(PROJECT_DIR, 'test')} -B {build_dir} -Wno-dev "
+            f"-DCMAKE_CXX_COMPILER=g++ -DCMAKE_C_COMPILER=gcc "
+            f"-DCTB_N_HASHED_NAMES={mode} > {os.devnull}"
+        ) != 0:
+            sys.exit(f"CTB_N_HASHED_NAMES={mode}: cmake configure failed")
+        start = time.perf_counter()
+        if os.system(f"cmake --build {build_dir} --config Debug > {os.devnull}") != 0:
+            sys.exit(f"CTB_N_HASHED_NAMES={mode}: build failed")
+        elapsed = time.perf_counter() - start
+        size = 0
+        for source in os.listdir(os.path.join(PROJECT_DIR, "test")):
+            name, ext = os.path.splitext(source)
+            if ext != ".cc":
+                continue
+            for binary in (name, f"{name}.exe", os.path.join("Debug", f"{name}.exe")):
+                if os.path.isfile(os.path.join(build_dir, binary)):
+                    size += os.path.getsize(os.path.join(build_dir, binary))
+        print(f"CTB_N_HASHED_NAMES={mode}: built in {elapsed:.1f}s, binaries take {size} bytes")
+
 if __name__ == '__main__':
     for dir in os.listdir(PROJECT_DIR):
         if dir.startswith('build'):
             shutil.rmtree(os.path.join(PROJECT_DIR, dir))
 
+    if "--report-hashed-names" in sys.argv:
+        report_hashed_names()
+        sys.exit(0)
+
     tests = [
         multiprocessing.Process(target=test_gcc),
         multiprocessing.Process(target=test_clang),
@@ -0,0 +1,65 @@
+#include <cassert>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <ctb/config.hh>
+
+using namespace ctb::namedtuple;
+
+consteval void test_parse_config() noexcept {
+    constexpr auto config = parse_config<"threads=8; batch = -256;\nmode=fast;;verbose=true">();
+    static_assert(get<"threads">(config) == 8);
+    static_assert(get<"batch">(config) == -256);
+    static_assert(get<"mode">(config) == "fast");
+    static_assert(get<"verbose">(config) == true);
+    using config_type = ::std::remove_cv_t<decltype(config)>;
+    static_assert(::std::is_same_v<::std::tuple_element_t<0, config_type>, long long>);
+    static_assert(::std::is_same_v<::std::tuple_element_t<3, config_type>, bool>);
+
+    constexpr auto limits = parse_config<"max=9223372036854775807;min=-9223372036854775808">();
+    static_assert(get<"max">(limits) == ::std::numeric_limits<long long>::max());
+    static_assert(get<"min">(limits) == ::std::numeric_limits<long long>::min());
+}
+
+template<is_namedtuple auto Config>
+struct Pipeline {
+    static constexpr auto threads = get<"threads">(Config);
+};
+
+consteval void test_config_as_template_argument() noexcept {
+    static_assert(Pipeline<parse_config<"threads=8;mode=fast">()>::threads == 8);
+}
+
+inline void runtime_test_parse_config() noexcept {
+    auto config = parse_config<"threads=8;batch=256;mode=fast;verbose=false">();
+    [[maybe_unused]] auto parsed =
+        parse_config(config, ::std::string_view{"threads = 16\nmode=slow\r\nverbose=true\n"});
+    assert(parsed);
+    assert(get<"threads">(config) == 16);
+    assert(get<"batch">(config) == 256);
+    assert(get<"mode">(config) == "slow");
+    assert(get<"verbose">(config) == true);
+
+    parsed = parse_config(config, ::std::string_view{"mode=ok"});
+    assert(parsed);
+    assert(get<"mode">(config) == "ok");
+
+    for (auto const text : {"thread=1", "threads=x", "threads", "mode=toolong", "verbose=1",
+                            "threads=99999999999999999999"}) {
+        parsed = parse_config(config, ::std::string_view{text});
+        assert(!parsed);
+    }
+
+    // a wider String in the schema takes values longer than the default
+    char mode[16]{"fast"};
+    auto wide = NamedTuple<names<"mode">, ctb::string::String<char, 16>>{mode};
+    parsed = parse_config(wide, ::std::string_view{"mode=toolong"});
+    assert(parsed);
+    assert(get<"mode">(wide) == "toolong");
+}
+
+int main() noexcept {
+    runtime_test_parse_config();
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <ctb/delta.hh>
+
+using namespace ctb::namedtuple;
+
+using quote = NamedTuple<names<"bid", "ask", "size", "venue">, double, double, int, char>;
+
+consteval void test_mask() noexcept {
+    static_assert(::std::is_same_v<Delta<quote>::mask_type, ::std::uint8_t>);
+    static_assert(::std::is_same_v<details::delta::mask_t<9>, ::std::uint16_t>);
+    static_assert(::std::is_same_v<details::delta::mask_t<64>, ::std::uint64_t>);
+    static_assert(::std::is_same_v<details::delta::mask_t<65>, ::std::array<::std::uint64_t, 2>>);
+    static_assert(sizeof(Delta<quote>{}.values) == 8 + 8 + 4 + 1);
+}
+
+inline void runtime_test_diff() noexcept {
+    auto const old_quote = quote{1.5, 1.75, 100, 'N'};
+    auto new_quote = old_quote;
+    assert(diff(old_quote, new_quote).empty());
+
+    get<"ask">(new_quote) = 1.8;
+    get<"venue">(new_quote) = 'Q';
+    auto const delta = diff(old_quote, new_quote);
+    assert(delta.mask == 0b1010);
+    assert(!delta.changed<0>() && delta.changed<1>() && !delta.changed<2>() && delta.changed<3>());
+    assert(delta.size == sizeof(double) + sizeof(char));
+
+    auto replica = old_quote;
+    apply_delta(replica, delta);
+    assert(get<"bid">(replica) == 1.5);
+    assert(get<"ask">(replica) == 1.8);
+    assert(get<"size">(replica) == 100);
+    assert(get<"venue">(replica) == 'Q');
+}
+
+inline void runtime_test_nested() noexcept {
+    using level = NamedTuple<names<"price", "size">, double, int>;
+    using book = NamedTuple<names<"bid", "ask", "seq">, level, level, long>;
+    static_assert(details::delta::can_diff<book>);
+    static_assert(!details::delta::can_diff<NamedTuple<names<"a">, NamedTuple<names<"b">, Delta<quote>>>>);
+
+    auto const old_book = book{level{1.5, 10}, level{1.75, 20}, 1l};
+    auto new_book = old_book;
+    get<"ask.size">(new_book) = 25;
+    auto const delta = diff(old_book, new_book);
+    assert(delta.mask == 0b010);
+    assert(delta.size == sizeof(level));
+
+    auto replica = old_book;
+    apply_delta(replica, delta);
+    assert(get<"ask.size">(replica) == 25 && get<"ask.price">(replica) == 1.75);
+}
+
+inline void runtime_test_encode() noexcept {
+    auto const old_quote = quote{1.5, 1.75, 100, 'N'};
+    auto new_quote = old_quote;
+    get<"size">(new_quote) = 150;
+
+    auto bytes = ::std::vector<::std::byte>{};
+    encode_delta(diff(old_quote, new_quote), bytes);
+    assert(bytes.size() == sizeof(Delta<quote>::mask_type) + sizeof(int));
+    assert(bytes.size() < sizeof(quote));
+
+    auto delta = Delta<quote>{};
+    assert(decode_delta(delta, ::std::span<::std::byte const>{bytes}));
+    auto replica = old_quote;
+    apply_delta(replica, delta);
+    assert(get<"size">(replica) == 150 && get<"bid">(replica) == 1.5);
+
+    bytes.pop_back();
+    assert(!decode_delta(delta, ::std::span<::std::byte const>{bytes}));
+    bytes.assign({::std::byte{0b1'0000}});  // no field 4
+    assert(!decode_delta(delta, ::std::span<::std::byte const>{bytes}));
+
+    bytes.clear();
+    encode_delta(Delta<quote>{}, bytes);
+    assert(bytes.size() == sizeof(Delta<quote>::mask_type));
+    assert(decode_delta(delta, ::std::span<::std::byte const>{bytes}) && delta.empty());
+}
+
+inline void runtime_test_wide() noexcept {
+    auto const old_nt = make_namedtuple<"a", "b">(Delta<quote>{}.mask, 0);
+    auto new_nt = old_nt;
+    get<"b">(new_nt) = 1;
+    auto copy = old_nt;
+    apply_delta(copy, diff(old_nt, new_nt));
+    assert(get<"b">(copy) == 1);
+
+    auto mask = details::delta::mask_t<130>{};
+    details::delta::set_bit(mask, 129);
+    details::delta::set_bit(mask, 3);
+    assert(details::delta::test_bit(mask, 129));
+    assert(details::delta::test_bit(mask, 3));
+    assert(!details::delta::test_bit(mask, 65));
+}
+
+inline void runtime_test_tracked() noexcept {
+    auto stored = quote{1.5, 1.75, 100, 'N'};
+    auto tracked = tracked_namedtuple(stored);
+    assert(tracked.dirty == 0);
+    assert(get<"bid">(::std::as_const(tracked)) == 1.5);
+    assert(tracked.take_delta().empty());
+
+    set<"size">(tracked, 200);
+    get<"bid">(tracked) += 0.25;
+    assert(tracked.is_dirty<"size">() && tracked.is_dirty<"bid">());
+    assert(!tracked.is_dirty<"ask">() && !tracked.is_dirty<3>());
+
+    auto const delta = tracked.take_delta();
+    assert(tracked.dirty == 0);
+    assert(delta.size == sizeof(double) + sizeof(int));
+    apply_delta(stored, delta);
+    assert(get<"bid">(stored) == 1.75);
+    assert(get<"size">(stored) == 200);
+    assert(tracked.take_delta().empty());
+}
+
+int main() noexcept {
+    runtime_test_diff();
+    runtime_test_nested();
+    runtime_test_encode();
+    runtime_test_wide();
+    runtime_test_tracked();
+
+    return 0;
+}
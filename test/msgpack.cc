@@ -0,0 +1,102 @@
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <ctb/msgpack.hh>
+
+using namespace ctb::namedtuple;
+
+using inner = NamedTuple<names<"host", "port">, ::std::string, unsigned short>;
+using message = NamedTuple<names<"id", "delta", "ok", "ratio", "tag", "peer">, unsigned long long, long long, bool,
+                           double, ctb::string::String<char, 8>, inner>;
+
+template<typename... Bytes>
+[[nodiscard]]
+::std::vector<::std::byte> bytes_of(Bytes... bytes) {
+    return {static_cast<::std::byte>(bytes)...};
+}
+
+consteval void test_keys() noexcept {
+    static_assert(details::msgpack::key<"id">.size() == 3);
+    static_assert(details::msgpack::key<"id">[0] == ::std::byte{0xa2});
+    static_assert(details::msgpack::key<"id">[1] == ::std::byte{'i'});
+    static_assert(details::msgpack::key<"a_name_longer_than_thirty_one_chars">[0] == ::std::byte{0xd9});
+    static_assert(details::msgpack::key<"a_name_longer_than_thirty_one_chars">[1] == ::std::byte{35});
+}
+
+inline void runtime_test_encoding() {
+    auto bytes = ::std::vector<::std::byte>{};
+    encode_msgpack(NamedTuple<names<"a", "b", "c">, int, bool, ::std::string>{-33, true, ::std::string{"hi"}}, bytes);
+    assert(bytes == bytes_of(0x83, 0xa1, 'a', 0xd0, 0xdf, 0xa1, 'b', 0xc3, 0xa1, 'c', 0xa2, 'h', 'i'));
+
+    bytes.clear();
+    encode_msgpack(NamedTuple<names<"u", "n">, unsigned, short>{300u, static_cast<short>(-5)}, bytes);
+    assert(bytes == bytes_of(0x82, 0xa1, 'u', 0xcd, 0x01, 0x2c, 0xa1, 'n', 0xfb));
+}
+
+inline void runtime_test_round_trip() {
+    auto const original = message{1ull << 40, -70000ll, true, -0.5, ctb::string::String{"edge\0\0\0"},
+                                  inner{::std::string(40, 'h'), static_cast<unsigned short>(8080)}};
+    auto bytes = ::std::vector<::std::byte>{};
+    encode_msgpack(original, bytes);
+
+    auto decoded = message{0ull, 0ll, false, 0.0, ctb::string::String{"1234567"},
+                           inner{::std::string{}, static_cast<unsigned short>(0)}};
+    [[maybe_unused]] auto decoded_ok = decode_msgpack(decoded, ::std::span{bytes});
+    assert(decoded_ok);
+    assert(get<"id">(decoded) == 1ull << 40);
+    assert(get<"delta">(decoded) == -70000);
+    assert(get<"ok">(decoded));
+    assert(get<"ratio">(decoded) == -0.5);
+    assert(get<"tag">(decoded) == "edge");
+    assert(get<"host">(get<"peer">(decoded)) == ::std::string(40, 'h'));
+    assert(get<"port">(get<"peer">(decoded)) == 8080);
+
+    decoded_ok = decode_msgpack(decoded, ::std::span{bytes}.first(bytes.size() - 1));
+    assert(!decoded_ok);
+}
+
+inline void runtime_test_foreign_maps() {
+    using point = NamedTuple<names<"x", "y">, int, float>;
+    auto p = point{0, 0.0f};
+
+    // keys in another order, an unknown key holding an array, and a float 64 into a float
+    auto const bytes = bytes_of(0x83, 0xa1, 'y', 0xcb, 0x3f, 0xf8, 0, 0, 0, 0, 0, 0, 0xa4, 'n', 'o', 'p', 'e', 0x92,
+                                0x01, 0xa1, 'z', 0xa1, 'x', 0x07);
+    [[maybe_unused]] auto decoded_ok = decode_msgpack(p, ::std::span{bytes});
+    assert(decoded_ok);
+    assert(get<"x">(p) == 7);
+    assert(get<"y">(p) == 1.5f);
+
+    // a value that doesn't fit its field
+    auto const too_big = bytes_of(0x81, 0xa1, 'x', 0xcf, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff);
+    decoded_ok = decode_msgpack(p, ::std::span{too_big});
+    assert(!decoded_ok);
+    auto const negative = bytes_of(0x81, 0xa1, 'b', 0xff);
+    auto u = NamedTuple<names<"b">, unsigned char>{static_cast<unsigned char>(0)};
+    decoded_ok = decode_msgpack(u, ::std::span{negative});
+    assert(!decoded_ok);
+}
+
+inline void runtime_test_long_str() {
+    // str 32 is the widest header, a longer string is refused before anything is written
+    auto bytes = ::std::vector<::std::byte>{};
+    [[maybe_unused]] auto thrown = false;
+    try {
+        details::msgpack::put_str(bytes, nullptr, ::std::size_t{1} << 32);
+    } catch (::std::length_error const&) {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(bytes.empty());
+}
+
+int main() noexcept {
+    runtime_test_encoding();
+    runtime_test_round_trip();
+    runtime_test_foreign_maps();
+    runtime_test_long_str();
+
+    return 0;
+}
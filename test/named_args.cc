@@ -0,0 +1,45 @@
+#include <cassert>
+#include <ctb/named_args.hh>
+
+using namespace ctb::namedtuple;
+
+using options = schema<field<"host", int>, field<"timeout", int, 30>, field<"retries", int, 3>>;
+
+constexpr int connect(int host, int timeout, int retries) noexcept {
+    return host * 10000 + timeout * 100 + retries;
+}
+
+consteval void test_invoke_named() noexcept {
+    static_assert(invoke_named<options>(connect, arg<"host"> = 1) == 1'30'03);
+    static_assert(invoke_named<options>(connect, arg<"retries"> = 5, arg<"host"> = 2) == 2'30'05);
+    static_assert(invoke_named<options>(connect, arg<"timeout"> = 7, arg<"retries"> = 9, arg<"host"> = 3) == 3'07'09);
+}
+
+consteval void test_make_namedtuple() noexcept {
+    constexpr auto opts = make_namedtuple<options>(arg<"retries"> = 5, arg<"host"> = 2);
+    static_assert(get<"host">(opts) == 2);
+    static_assert(get<"timeout">(opts) == 30);
+    static_assert(get<"retries">(opts) == 5);
+}
+
+consteval void test_duplicate_args() noexcept {
+    // invoke_named and make_namedtuple reject a call like f(arg<"host"> = 1, arg<"host"> = 2)
+    static_assert(details::unique_names<details::arg_names<decltype(arg<"host"> = 1), decltype(arg<"retries"> = 2)>>);
+    static_assert(!details::unique_names<details::arg_names<decltype(arg<"host"> = 1), decltype(arg<"host"> = 2)>>);
+}
+
+inline void runtime_test_by_reference() noexcept {
+    auto counter = 0;
+    invoke_named<schema<field<"counter", int&>, field<"step", int, 2>>>(
+        [](int& c, int step) noexcept {
+            c += step;
+        },
+        arg<"counter"> = counter);
+    assert(counter == 2);
+}
+
+int main() noexcept {
+    runtime_test_by_reference();
+
+    return 0;
+}
@@ -1,4 +1,9 @@
+#include <cassert>
+#include <memory>
+#include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 #include <ctb/namedtuple.hh>
 
 using namespace ctb::namedtuple;
@@ -11,6 +16,55 @@ consteval void test_names() noexcept {
     static_assert(details::get_size<names<"a", "blabla">>() == 2);
 }
 
+consteval void test_unique_names() noexcept {
+    static_assert(details::unique_names<names<"a">>);
+    static_assert(details::unique_names<names<"a", "b", "ab", "ba">>);
+    static_assert(!details::unique_names<names<"a", "b", "a">>);
+    static_assert(!details::unique_names<names<"x", "y", "z", "w", "v", "u", "t", "s", "r", "q", "p", "y">>);
+    // names are compared by code units, whatever their character type
+    static_assert(!details::unique_names<names<"id", u8"id">>);
+    static_assert(details::unique_names<names<u8"滑稽", "bla">>);
+}
+
+template<::std::size_t I>
+constexpr auto field_name = [] {
+    char const name[]{'f', static_cast<char>('0' + I / 100), static_cast<char>('0' + I / 10 % 10),
+                      static_cast<char>('0' + I % 10), '\0'};
+    return ctb::string::String{name};
+}();
+
+template<typename>
+struct large_;
+
+template<::std::size_t... I>
+struct large_<::std::index_sequence<I...>> {
+    using type = NamedTuple<names<field_name<I>..., "last">, decltype(static_cast<int>(I))..., int>;
+
+    static constexpr type value{static_cast<int>(I)..., -1};
+};
+
+// past gcc's default template depth of 900, nothing may recurse once per name
+consteval void test_large_schema() noexcept {
+    using large = large_<::std::make_index_sequence<1000>>;
+    static_assert(::std::tuple_size_v<large::type> == 1001);
+    static_assert(details::unique_names<large::type::names>);
+    static_assert(details::get_name<1000, large::type::names>() == "last");
+    static_assert(get<"f999">(large::value) == 999);
+    static_assert(get<"last">(large::value) == -1);
+}
+
+consteval void test_keys() noexcept {
+#ifdef CTB_N_HASHED_NAMES
+    static_assert(
+        ::std::is_same_v<names<"a", "b">, details::names<details::hashed::hash<"a">(), details::hashed::hash<"b">()>>);
+    static_assert(::std::is_same_v<names<"id">, names<u8"id">>);
+#else
+    static_assert(
+        ::std::is_same_v<names<"a", "b">, details::names<ctb::string::String{"a"}, ctb::string::String{"b"}>>);
+#endif  // CTB_N_HASHED_NAMES
+    static_assert(details::name_of<details::key_of<u8"id">> == "id");
+}
+
 consteval void test_namedtuple() noexcept {
     constexpr auto nt = make_namedtuple<u8"hhh", "blaa">(1, u8"233hh");
     static_assert(::std::u8string_view{get<"blaa">(nt)} == u8"233hh");
@@ -18,6 +72,173 @@ consteval void test_namedtuple() noexcept {
     [[maybe_unused]] auto [a, b]{nt};
 }
 
+template<is_namedtuple auto Config>
+struct Worker {
+    static constexpr auto threads = get<"threads">(Config);
+    static constexpr auto batch = get<"batch">(Config);
+};
+
+consteval void test_structural() noexcept {
+    using worker = Worker<make_namedtuple<"threads", "batch">(8, 256u)>;
+    static_assert(worker::threads == 8);
+    static_assert(worker::batch == 256u);
+    static_assert(::std::is_same_v<Worker<make_namedtuple<"threads", "batch">(8, 256u)>, worker>);
+    static_assert(!::std::is_same_v<Worker<make_namedtuple<"threads", "batch">(4, 256u)>, worker>);
+}
+
+using options = schema<field<"host", int>, field<"timeout", int, 30>, field<"retries", unsigned, 3u>>;
+
+constinit auto all_defaults = make_namedtuple<schema<field<"a", int, 1>, field<"b", long, 2>>>();
+
+consteval void test_defaults() noexcept {
+    constexpr auto opts = make_namedtuple<options, "host">(1);
+    static_assert(get<"host">(opts) == 1);
+    static_assert(get<"timeout">(opts) == 30);
+    static_assert(get<"retries">(opts) == 3u);
+
+    constexpr auto opts2 = make_namedtuple<options, "retries", "host">(5u, 2);
+    static_assert(get<"host">(opts2) == 2);
+    static_assert(get<"timeout">(opts2) == 30);
+    static_assert(get<"retries">(opts2) == 5u);
+    static_assert(::std::is_same_v<decltype(opts2), options::type const>);
+}
+
+consteval void test_fingerprint() noexcept {
+    using a = NamedTuple<names<"x", "y">, int, double>;
+    static_assert(fingerprint<a>() == fingerprint<NamedTuple<names<u8"x", "y">, int, double>>());
+    static_assert(fingerprint<a>() != fingerprint<NamedTuple<names<"x", "z">, int, double>>());
+    static_assert(fingerprint<a>() != fingerprint<NamedTuple<names<"y", "x">, int, double>>());
+    static_assert(fingerprint<a>() != fingerprint<NamedTuple<names<"x", "y">, unsigned, double>>());
+    static_assert(fingerprint<a>() != fingerprint<NamedTuple<names<"x", "y">, int, float>>());
+    static_assert(fingerprint<a>() != fingerprint<NamedTuple<names<"xy">, long>>());
+    static_assert(fingerprint<NamedTuple<names<"n">, a>>() !=
+                  fingerprint<NamedTuple<names<"n">, NamedTuple<names<"x", "y">, int, long>>>());
+}
+
+consteval void test_reorder() noexcept {
+    constexpr auto abc = make_namedtuple<"a", "b", "c">(1, 2.5, 'c');
+    constexpr auto cab = reorder_as<names<"c", "a", "b">>(abc);
+    static_assert(::std::is_same_v<decltype(cab), NamedTuple<names<"c", "a", "b">, char, int, double> const>);
+    static_assert(get<0>(cab) == 'c' && get<1>(cab) == 1 && get<2>(cab) == 2.5);
+
+    constexpr NamedTuple<names<"b", "c", "a">, double, char, long> bca{cab};
+    static_assert(get<"a">(bca) == 1 && get<"b">(bca) == 2.5 && get<"c">(bca) == 'c');
+
+    static_assert(details::is_permutation<names<"a", "b">, names<"b", "a">>);
+    static_assert(!details::is_permutation<names<"a", "b">, names<"a", "c">>);
+    static_assert(!details::is_permutation<names<"a", "b">, names<"a">>);
+    static_assert(
+        !::std::is_constructible_v<NamedTuple<names<"x", "y">, int, int>, NamedTuple<names<"x", "z">, int, int>>);
+}
+
+consteval void test_noexcept() noexcept {
+    using plain = NamedTuple<names<"a", "b">, int, double>;
+    using owning = NamedTuple<names<"a", "s">, int, ::std::string>;
+    static_assert(::std::is_nothrow_constructible_v<plain, int const&, double const&>);
+    static_assert(::std::is_nothrow_constructible_v<NamedTuple<names<"b", "a">, double, int>, plain const&>);
+
+    // copying a string may throw, moving it doesn't
+    static_assert(!::std::is_nothrow_constructible_v<owning, int const&, ::std::string const&>);
+    static_assert(::std::is_nothrow_constructible_v<owning, int, ::std::string>);
+    static_assert(!::std::is_nothrow_constructible_v<NamedTuple<names<"s", "a">, ::std::string, int>, owning const&>);
+    static_assert(::std::is_nothrow_constructible_v<NamedTuple<names<"s", "a">, ::std::string, int>, owning>);
+    static_assert(!noexcept(make_namedtuple<"s">(::std::declval<::std::string const&>())));
+}
+
+using headers = NamedTuple<names<"host", "length">, char const*, int>;
+using request = NamedTuple<names<"method", "headers">, char, headers>;
+using event = NamedTuple<names<"id", "request", "a.b">, long, request, int>;
+
+consteval void test_path() noexcept {
+    constexpr auto e = event{7l, request{'G', headers{"example.com", 12}}, 3};
+    static_assert(get<"request.headers.length">(e) == 12);
+    static_assert(get<"request.method">(e) == 'G');
+    static_assert(get<"a.b">(e) == 3);
+    static_assert(::std::is_same_v<decltype(get<"request.headers">(e)), headers const&>);
+
+    using flat = flattened_t<event>;
+    static_assert(::std::is_same_v<flat, NamedTuple<names<"id", "request.method", "request.headers.host",
+                                                         "request.headers.length", "a.b">,
+                                                   long, char, char const*, int, int>>);
+    constexpr auto f = flatten(e);
+    static_assert(get<"request.headers.length">(f) == 12);
+    static_assert(get<4>(f) == 3);
+    static_assert(::std::is_same_v<flattened_t<headers>, headers>);
+}
+
+template<is_namedtuple NT>
+inline double total(NT const& nt) noexcept {
+    return get<"price">(nt) * get<"qty">(nt);
+}
+
+inline void runtime_test_tie() noexcept {
+    auto price = 2.5;
+    auto qty = 4;
+    auto tie = named_tie<"price", "qty">(price, qty);
+    static_assert(::std::is_same_v<decltype(tie), NamedTuple<names<"price", "qty">, double&, int&>>);
+    assert(&get<"price">(tie) == &price);
+    assert(total(tie) == 10.0);
+    get<"qty">(tie) = 2;
+    assert(qty == 2);
+
+    auto count = 3;
+    auto ptr = ::std::make_unique<int>(1);
+    auto forwarded = forward_as_namedtuple<"price", "qty", "owner">(price, ::std::move(count), ::std::move(ptr));
+    using forwarded_type = NamedTuple<names<"price", "qty", "owner">, double&, int&&, ::std::unique_ptr<int>&&>;
+    static_assert(::std::is_same_v<decltype(forwarded), forwarded_type>);
+    assert(&get<"price">(forwarded) == &price);
+    assert(get<"qty">(forwarded) == 3);
+    auto const owner = ::std::move(get<"owner">(forwarded));
+    assert(*owner == 1 && ptr == nullptr);
+}
+
+inline void runtime_test_reorder() noexcept {
+    auto nt = make_namedtuple<"id", "payload">(7, ::std::make_unique<int>(42));
+    [[maybe_unused]] auto const* const payload = get<"payload">(nt).get();
+    auto moved = reorder_as<names<"payload", "id">>(::std::move(nt));
+    assert(get<"payload">(nt) == nullptr);
+    assert(get<0>(moved).get() == payload);
+    assert(get<"id">(moved) == 7);
+}
+
+inline void runtime_test_get() noexcept {
+    auto e = event{7l, request{'G', headers{"example.com", 12}}, 3};
+    get<"request.headers.length">(e) = 13;
+    assert(get<1>(get<1>(get<1>(e))) == 13);
+
+    auto x = 1;
+    auto nt = make_namedtuple<"x", "y">(x, 2.5);
+    get<"x">(nt) = 3;
+    assert(get<0>(nt) == 3);
+    auto& [a, b] = nt;
+    b = 1.5;
+    assert(get<"y">(nt) == 1.5);
+    assert(a == 3);
+    assert(get<"b">(all_defaults) == 2);
+}
+
+template<::std::size_t I, typename NT>
+inline ::std::size_t actual_offset(NT const& nt) noexcept {
+    return static_cast<::std::size_t>(reinterpret_cast<char const*>(&get<I>(nt)) - reinterpret_cast<char const*>(&nt));
+}
+
+inline void runtime_test_offset_of() noexcept {
+    auto const a = make_namedtuple<"a", "b", "c", "d">('x', 1.0, short{2}, 3);
+    assert((offset_of<0, decltype(a)>() == actual_offset<0>(a)));
+    assert((offset_of<1, decltype(a)>() == actual_offset<1>(a)));
+    assert((offset_of<2, decltype(a)>() == actual_offset<2>(a)));
+    assert((offset_of<3, decltype(a)>() == actual_offset<3>(a)));
+
+    [[maybe_unused]] auto const b = make_namedtuple<"x", "y", "z">(a, 'c', make_namedtuple<"p">(char{}));
+    assert((offset_of<1, decltype(b)>() == actual_offset<1>(b)));
+    assert((offset_of<2, decltype(b)>() == actual_offset<2>(b)));
+}
+
 int main() noexcept {
+    runtime_test_get();
+    runtime_test_reorder();
+    runtime_test_tie();
+    runtime_test_offset_of();
+
     return 0;
 }
@@ -0,0 +1,30 @@
+#include <cassert>
+#include <string_view>
+#include <ctb/perfect_hash.hh>
+
+using namespace ctb::namedtuple;
+
+consteval void test_find_name() noexcept {
+    using schema = names<"threads", "batch", u8"mode">;
+    static_assert(find_name<schema>("threads") == 0);
+    static_assert(find_name<schema>(u8"batch") == 1);
+    static_assert(find_name<schema>("mode") == 2);
+    static_assert(find_name<schema>("mod") == 3);
+    static_assert(find_name<schema>("") == 3);
+
+    // duplicate names end the seed search at once, find_name then fails its static_assert
+    static_assert(details::perfect_hash::name_table<names<"a", "b", "a">>::found.slot_count == 4);
+}
+
+inline void runtime_test_find_name() noexcept {
+    using schema [[maybe_unused]] = names<"threads", "batch", "mode">;
+    assert(find_name<schema>(::std::string_view{"batch"}) == 1);
+    assert(find_name<schema>(::std::u8string_view{u8"mode"}) == 2);
+    assert(find_name<schema>(::std::string_view{"batches"}) == 3);
+}
+
+int main() noexcept {
+    runtime_test_find_name();
+
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include <atomic>
+#include <string>
+#include <cassert>
+#include <thread>
+#include <vector>
+#include <ctb/rcu.hh>
+
+using namespace ctb::namedtuple;
+
+using config = NamedTuple<names<"version", "threads", "name">, long, long, ::std::string>;
+
+inline void runtime_test_publish() {
+    auto cell = RcuCell<config, 2>{config{1l, 4l, "alpha"}};
+    auto reader = cell.reader();
+    assert(reader.has_value());
+    {
+        auto const snapshot = reader->read();
+        assert(get<"threads">(*snapshot) == 4);
+
+        // the snapshot being read is kept alive across a publish
+        cell.publish(config{2l, 8l, "beta"});
+        assert(get<"version">(*snapshot) == 1);
+        assert(cell.reclaim() == 1);
+    }
+    assert(cell.reclaim() == 0);
+    assert(get<"version">(*reader->read()) == 2);
+
+    // slots are released with their reader
+    auto second = cell.reader();
+    assert(second.has_value());
+    assert(!cell.reader().has_value());
+    second.reset();
+    assert(cell.reader().has_value());
+}
+
+inline void runtime_test_concurrent() {
+    // every snapshot must satisfy threads == version * 2
+    auto cell = RcuCell<config>{config{0l, 0l, "x"}};
+    auto done = ::std::atomic<bool>{};
+    auto readers = ::std::vector<::std::jthread>{};
+    for (int i{}; i < 3; ++i) {
+        readers.emplace_back([&] {
+            auto reader = cell.reader();
+            assert(reader.has_value());
+            while (!done.load(::std::memory_order_relaxed)) {
+                auto const snapshot = reader->read();
+                assert(get<"threads">(*snapshot) == get<"version">(*snapshot) * 2);
+            }
+        });
+    }
+    for (long i{1}; i <= 20'000; ++i) {
+        cell.publish(config{i, i * 2, "x"});
+    }
+    done.store(true, ::std::memory_order_relaxed);
+    readers.clear();
+    assert(cell.reclaim() == 0);
+}
+
+int main() noexcept {
+    runtime_test_publish();
+    runtime_test_concurrent();
+
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <ctb/record_log.hh>
+
+using namespace ctb::namedtuple;
+
+using event = NamedTuple<names<"ts", "value">, long, double>;
+
+constexpr char const* path = "record_log_test.log";
+
+consteval void test_crc32() noexcept {
+    constexpr ::std::byte check[]{::std::byte{'1'}, ::std::byte{'2'}, ::std::byte{'3'},
+                                  ::std::byte{'4'}, ::std::byte{'5'}, ::std::byte{'6'},
+                                  ::std::byte{'7'}, ::std::byte{'8'}, ::std::byte{'9'}};
+    static_assert(details::record_log::crc32(check, sizeof(check)) == 0xcbf43926u);
+}
+
+struct packed_pair {
+    ::std::int32_t a;
+    ::std::int32_t b;
+};
+
+struct padded_pair {
+    char a;
+    ::std::int32_t b;
+};
+
+// a plain struct field is only logged if it has no padding, which would be written unzeroed
+template<typename NT>
+concept can_log = requires { typename RecordWriter<NT>; };
+
+consteval void test_loggable() noexcept {
+    static_assert(can_log<event>);
+    static_assert(can_log<NamedTuple<names<"pair", "samples">, packed_pair, double[4]>>);
+    static_assert(can_log<NamedTuple<names<"tag", "at">, char, NamedTuple<names<"ts">, long>>>);
+    static_assert(!can_log<NamedTuple<names<"pair">, padded_pair>>);
+    static_assert(!can_log<NamedTuple<names<"x">, long double>>);
+}
+
+inline void runtime_test_write_and_tail() {
+    static_cast<void>(::std::remove(path));
+    auto writer = RecordWriter<event>{path, LogOptions{.buffer_bytes = 10 * (16 + sizeof(event)), .sync_every = 0}};
+    assert(writer.is_open());
+    [[maybe_unused]] auto written = true;
+    for (long i{}; i < 25; ++i) {
+        written = writer.append(event{i, static_cast<double>(i) / 2});
+        assert(written);
+    }
+
+    auto reader = RecordReader<event>{path};
+    assert(reader.is_open());
+    auto ev = event{-1l, 0.0};
+    [[maybe_unused]] auto status = read_status::ok;
+    // only the full batches have been written so far
+    for (long i{}; i < 20; ++i) {
+        status = reader.next(ev);
+        assert(status == read_status::ok);
+        assert(get<"ts">(ev) == i);
+        assert(get<"value">(ev) == static_cast<double>(i) / 2);
+    }
+    status = reader.next(ev);
+    assert(status == read_status::end);
+    assert(get<"ts">(ev) == 19);
+
+    written = writer.sync();
+    assert(written);
+    for (long i{20}; i < 25; ++i) {
+        status = reader.next(ev);
+        assert(status == read_status::ok);
+        assert(get<"ts">(ev) == i);
+    }
+    status = reader.next(ev);
+    assert(status == read_status::end);
+
+    written = writer.append(event{25l, 0.0}) && writer.flush();
+    assert(written);
+    status = reader.next(ev);
+    assert(status == read_status::ok);
+    assert(get<"ts">(ev) == 25);
+}
+
+inline void runtime_test_padding() {
+    using padded = NamedTuple<names<"flag", "at">, char, NamedTuple<names<"ok", "ts">, bool, long>>;
+    static_assert(!details::record_log::field_bytes<padded>[1] && details::record_log::field_bytes<padded>[8]);
+    static_assert(!details::record_log::field_bytes<padded>[9] && details::record_log::field_bytes<padded>[16]);
+
+    constexpr char const* padded_path = "record_log_padding.log";
+    static_cast<void>(::std::remove(padded_path));
+    alignas(padded) ::std::byte storage[sizeof(padded)];
+    ::std::memset(storage, 0xab, sizeof(storage));
+    auto const* const record = ::new (static_cast<void*>(storage)) padded{'x', {true, 7l}};
+    {
+        auto writer = RecordWriter<padded>{padded_path};
+        [[maybe_unused]] auto const written = writer.append(*record);
+        assert(written);
+    }
+
+    ::std::byte frame[16 + sizeof(padded)];
+    auto* file = ::std::fopen(padded_path, "rb");
+    assert(file != nullptr);
+    [[maybe_unused]] auto const frames = ::std::fread(frame, sizeof(frame), 1, file);
+    assert(frames == 1);
+    ::std::fclose(file);
+    for (::std::size_t i{}; i < sizeof(padded); ++i) {
+        assert(details::record_log::field_bytes<padded>[i] || frame[16 + i] == ::std::byte{});
+    }
+
+    auto reader = RecordReader<padded>{padded_path};
+    auto read = padded{' ', {false, 0l}};
+    [[maybe_unused]] auto const status = reader.next(read);
+    assert(status == read_status::ok);
+    assert(get<"flag">(read) == 'x' && get<"at.ts">(read) == 7);
+    static_cast<void>(::std::remove(padded_path));
+}
+
+inline void runtime_test_schema_mismatch() noexcept {
+    auto reader = RecordReader<NamedTuple<names<"ts", "val">, long, double>>{path};
+    auto ev = make_namedtuple<"ts", "val">(0l, 0.0);
+    [[maybe_unused]] auto const status = reader.next(ev);
+    assert(status == read_status::schema_mismatch);
+}
+
+inline void runtime_test_corrupt() noexcept {
+    auto* file = ::std::fopen(path, "r+b");
+    assert(file != nullptr);
+    [[maybe_unused]] auto const seeked = ::std::fseek(file, 16, SEEK_SET);
+    assert(seeked == 0);
+    ::std::fputc(0x7f, file);
+    ::std::fclose(file);
+
+    auto reader = RecordReader<event>{path};
+    auto ev = event{0l, 0.0};
+    [[maybe_unused]] auto const status = reader.next(ev);
+    assert(status == read_status::corrupt);
+}
+
+int main() noexcept {
+    runtime_test_write_and_tail();
+    runtime_test_padding();
+    runtime_test_schema_mismatch();
+    runtime_test_corrupt();
+    static_cast<void>(::std::remove(path));
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <ctb/reflect.hh>
+
+using namespace ctb::namedtuple;
+
+using point = NamedTuple<names<"x", "y">, float, float>;
+using sample = NamedTuple<names<"id", u8"温度", "valid", "at">, ::std::uint16_t, double, bool, point>;
+
+// a namedtuple of references has no layout to describe
+template<typename NT>
+concept has_fields = requires { fields<NT>; };
+
+template<typename NT>
+concept has_offsets = requires { offset_of<1, NT>(); };
+
+consteval void test_fields() noexcept {
+    static_assert(fields<sample>.size() == 4);
+    static_assert(fields<sample>[0].name == "id");
+    static_assert(fields<sample>[1].name == "\xe6\xb8\xa9\xe5\xba\xa6");
+    static_assert(fields<sample>[1].offset == offset_of<1, sample>());
+    static_assert(fields<sample>[1].size == sizeof(double));
+    static_assert(fields<sample>[1].align == alignof(double));
+    static_assert(fields<sample>[0].tag == type_tag::unsigned_integer);
+    static_assert(fields<sample>[1].tag == type_tag::floating_point);
+    static_assert(fields<sample>[2].tag == type_tag::boolean);
+    static_assert(fields<sample>[3].tag == type_tag::namedtuple);
+    static_assert(fields<sample>[0].nested.empty());
+    static_assert(fields<sample>[3].nested.data() == fields<point>.data());
+    static_assert(fields<sample const&>.data() == fields<sample>.data());
+
+    static_assert(find_field(fields<sample>, "valid") == &fields<sample>[2]);
+    static_assert(find_field(fields<sample>, "nope") == nullptr);
+
+    using tied = NamedTuple<names<"id", "at">, ::std::uint16_t&, point>;
+    static_assert(has_fields<sample> && has_offsets<sample>);
+    static_assert(!has_fields<tied> && !has_offsets<tied>);
+    static_assert(!has_fields<NamedTuple<names<"x">, double&&>>);
+}
+
+/* a printer that is compiled once, whatever the schema
+ */
+inline void print(::std::string& out, ::std::span<field_info const> const fields, void const* const nt) {
+    auto const* const base = static_cast<char const*>(nt);
+    out += '{';
+    for (auto const& field : fields) {
+        out.append(field.name).append("=");
+        auto const* const value = base + field.offset;
+        if (field.tag == type_tag::namedtuple) {
+            print(out, field.nested, value);
+        } else if (field.tag == type_tag::floating_point && field.size == sizeof(float)) {
+            float f;
+            ::std::memcpy(&f, value, sizeof(f));
+            out += ::std::to_string(static_cast<int>(f));
+        } else if (field.tag == type_tag::unsigned_integer || field.tag == type_tag::boolean) {
+            ::std::uint64_t u{};
+            ::std::memcpy(&u, value, field.size);  // little-endian
+            out += ::std::to_string(u);
+        } else {
+            out += '?';
+        }
+        out += ';';
+    }
+    out += '}';
+}
+
+inline void runtime_test_print() {
+    auto const s = sample{7, 21.5, true, point{1.0f, 2.0f}};
+    auto out = ::std::string{};
+    print(out, fields<sample>, &s);
+    assert(out == "{id=7;\xe6\xb8\xa9\xe5\xba\xa6=?;valid=1;at={x=1;y=2;};}");
+
+    [[maybe_unused]] auto const* const valid = find_field(fields<sample>, "valid");
+    assert(valid != nullptr);
+    assert(reinterpret_cast<char const*>(&s) + valid->offset == reinterpret_cast<char const*>(&get<"valid">(s)));
+}
+
+int main() noexcept {
+    runtime_test_print();
+
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include <atomic>
+#include <cassert>
+#include <thread>
+#include <vector>
+#include <ctb/seqlock.hh>
+
+using namespace ctb::namedtuple;
+
+using quote = NamedTuple<names<"bid", "ask", "seq", "venue">, double, double, long, char>;
+
+inline void runtime_test_load_store() noexcept {
+    auto shared = SeqlockNamedTuple<quote>{quote{1.0, 2.0, 0l, 'N'}};
+    [[maybe_unused]] auto snapshot = shared.load();
+    assert(get<"ask">(snapshot) == 2.0);
+
+    shared.store(quote{1.5, 2.5, 1l, 'Q'});
+    [[maybe_unused]] auto [bid, venue] = shared.load<"bid", "venue">();
+    assert(bid == 1.5);
+    assert(venue == 'Q');
+
+    shared.store<"venue">('X');
+    shared.store<"seq">(7);
+    snapshot = shared.load();
+    assert(get<"bid">(snapshot) == 1.5);
+    assert(get<"ask">(snapshot) == 2.5);
+    assert(get<"seq">(snapshot) == 7);
+    assert(get<"venue">(snapshot) == 'X');
+}
+
+inline void runtime_test_concurrent() {
+    // every snapshot must satisfy ask == bid + 1 and seq == bid
+    auto shared = SeqlockNamedTuple<quote>{quote{0.0, 1.0, 0l, 'N'}};
+    auto done = ::std::atomic<bool>{};
+    auto readers = ::std::vector<::std::jthread>{};
+    for (int i{}; i < 3; ++i) {
+        readers.emplace_back([&] {
+            while (!done.load(::std::memory_order_relaxed)) {
+                [[maybe_unused]] auto const snapshot = shared.load();
+                assert(get<"ask">(snapshot) == get<"bid">(snapshot) + 1);
+                assert(static_cast<double>(get<"seq">(snapshot)) == get<"bid">(snapshot));
+                [[maybe_unused]] auto const [bid, seq] = shared.load<"bid", "seq">();
+                assert(static_cast<double>(seq) == bid);
+            }
+        });
+    }
+    for (long i{1}; i <= 100'000; ++i) {
+        auto const bid = static_cast<double>(i);
+        shared.store(quote{bid, bid + 1, i, 'N'});
+    }
+    done.store(true, ::std::memory_order_relaxed);
+}
+
+int main() noexcept {
+    runtime_test_load_store();
+    runtime_test_concurrent();
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include <cassert>
+#include <ctb/shm_ring.hh>
+
+#ifdef CTB_SHM_RING_SUPPORT
+    #include <cstdint>
+    #include <string>
+    #include <thread>
+
+using namespace ctb::namedtuple;
+
+using event = NamedTuple<names<"ts", "value">, long, double>;
+using other = NamedTuple<names<"ts", "count">, long, long>;
+
+inline ::std::string const name = "/ctb_ring_" + ::std::to_string(::getpid());
+
+inline void runtime_test_push_pop() {
+    auto producer = ShmRing<event>::create(name.c_str(), 3);
+    assert(producer.status() == shm_status::ok);
+    assert(producer.capacity() == 4);
+
+    auto consumer = ShmRing<event>::attach(name.c_str());
+    assert(consumer.status() == shm_status::ok);
+    assert(ShmRing<other>::attach(name.c_str()).status() == shm_status::schema_mismatch);
+
+    auto ev = event{-1l, 0.0};
+    [[maybe_unused]] auto popped = consumer.try_pop(ev);
+    assert(!popped);
+    [[maybe_unused]] auto pushed = true;
+    for (long i{}; i < 4; ++i) {
+        pushed = producer.try_push(event{i, static_cast<double>(i) / 2});
+        assert(pushed);
+    }
+    pushed = producer.try_push(event{4l, 2.0});
+    assert(!pushed);
+    popped = consumer.try_pop(ev);
+    assert(popped && get<"ts">(ev) == 0);
+    pushed = producer.try_push(event{4l, 2.0});
+    assert(pushed);
+    for (long i{1}; i < 5; ++i) {
+        popped = consumer.try_pop(ev);
+        assert(popped);
+        assert(get<"ts">(ev) == i);
+        assert(get<"value">(ev) == static_cast<double>(i) / 2);
+    }
+    popped = consumer.try_pop(ev);
+    assert(!popped);
+
+    // a segment in use is never reset
+    pushed = producer.try_push(event{5l, 2.5});
+    assert(pushed);
+    [[maybe_unused]] auto const again = ShmRing<event>::create(name.c_str(), 3).status();
+    assert(again == shm_status::exists);
+    popped = consumer.try_pop(ev);
+    assert(popped && get<"ts">(ev) == 5);
+
+    [[maybe_unused]] auto const unlinked = ShmRing<event>::unlink(name.c_str());
+    assert(unlinked);
+    assert(ShmRing<event>::attach(name.c_str()).status() == shm_status::unavailable);
+}
+
+inline void runtime_test_bad_capacity() {
+    auto ring = ShmRing<event>::create(name.c_str(), 4);
+    assert(ring.status() == shm_status::ok);
+
+    auto const fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+    assert(fd != -1);
+    auto* const segment = ::mmap(nullptr, sizeof(details::shm_ring::header), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    assert(segment != MAP_FAILED);
+    auto* const header = static_cast<details::shm_ring::header*>(segment);
+
+    for (auto const capacity : {::std::uint64_t{0}, ::std::uint64_t{3}, ::std::uint64_t{8}}) {
+        header->capacity = capacity;
+        assert(ShmRing<event>::attach(name.c_str()).status() == shm_status::unavailable);
+    }
+    header->capacity = 4;
+    assert(ShmRing<event>::attach(name.c_str()).status() == shm_status::ok);
+
+    ::munmap(segment, sizeof(details::shm_ring::header));
+    [[maybe_unused]] auto const unlinked = ShmRing<event>::unlink(name.c_str());
+    assert(unlinked);
+}
+
+inline void runtime_test_concurrent() {
+    // the producer and the consumer use separate mappings of the segment
+    auto producer = ShmRing<event>::create(name.c_str(), 64);
+    auto consumer = ShmRing<event>::attach(name.c_str());
+    [[maybe_unused]] auto const unlinked = ShmRing<event>::unlink(name.c_str());
+    assert(unlinked && consumer.status() == shm_status::ok);
+
+    constexpr long count = 100'000;
+    auto thread = ::std::jthread{[&] {
+        for (long i{}; i < count;) {
+            if (producer.try_push(event{i, static_cast<double>(i)})) {
+                ++i;
+            } else {
+                ::std::this_thread::yield();
+            }
+        }
+    }};
+    auto ev = event{-1l, 0.0};
+    for (long i{}; i < count;) {
+        if (consumer.try_pop(ev)) {
+            assert(get<"ts">(ev) == i);
+            assert(get<"value">(ev) == static_cast<double>(i));
+            ++i;
+        } else {
+            ::std::this_thread::yield();
+        }
+    }
+}
+
+int main() noexcept {
+    runtime_test_push_pop();
+    runtime_test_bad_capacity();
+    runtime_test_concurrent();
+
+    return 0;
+}
+
+#else
+
+int main() noexcept {
+    return 0;
+}
+
+#endif
@@ -0,0 +1,144 @@
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <ctb/sparse.hh>
+
+using namespace ctb::namedtuple;
+
+using telemetry = NamedTuple<names<"rpm", "temp", "fault", "speed">, double, float, ::std::uint8_t, ::std::int32_t>;
+
+consteval void test_groups() noexcept {
+    using groups = SparseNamedTuple<telemetry>::groups;
+    static_assert(groups::count == 3);
+    static_assert(groups::group_of == ::std::array<::std::size_t, 4>{0, 1, 2, 1});
+    static_assert(groups::masks[1][0] == 0b1010);
+    static_assert(sizeof(SparseNamedTuple<telemetry>::chunk_type) == alignof(double));
+    static_assert(SparseNamedTuple<telemetry>::words_count == 1);
+    static_assert(SparseNamedTuple<telemetry>{}.size() == 0);
+}
+
+inline void runtime_test_sparse() {
+    auto sparse = SparseNamedTuple<telemetry>{};
+    assert(sparse.size() == 0);
+    assert(get<"rpm">(sparse) == nullptr);
+
+    set<"speed">(sparse, 120);
+    set<"rpm">(sparse, 3000);
+    assert(sparse.size() == 2 && sparse.bytes() == 12);
+    assert(sparse.has<"rpm">() && !sparse.has<"temp">() && sparse.has<3>());
+    assert(*get<"rpm">(sparse) == 3000.0);
+    assert(*get<"speed">(sparse) == 120);
+
+    set<"fault">(sparse, ::std::uint8_t{7});
+    assert(sparse.rank<2>() == 0 && sparse.rank<3>() == 0);
+    assert(sparse.bytes() == 13 && sparse.values.size() == 2);
+    assert(*get<"speed">(::std::as_const(sparse)) == 120);
+    static_assert(::std::is_same_v<decltype(get<"fault">(::std::as_const(sparse))), ::std::uint8_t const*>);
+
+    *get<"fault">(sparse) += 1;
+    set<"rpm">(sparse, 3100);
+    assert(sparse.size() == 3);
+    assert(*get<2>(sparse) == 8);
+    assert(*get<0>(sparse) == 3100.0);
+
+    erase<"rpm">(sparse);
+    erase<"temp">(sparse);
+    assert(sparse.size() == 2 && sparse.bytes() == 5);
+    assert(get<"rpm">(sparse) == nullptr);
+    assert(*get<"fault">(sparse) == 8 && *get<"speed">(sparse) == 120);
+
+    sparse.clear();
+    assert(sparse.size() == 0 && !sparse.has<"speed">());
+}
+
+template<::std::size_t I>
+constexpr auto field_name = [] {
+    char const name[]{'f', static_cast<char>('0' + I / 100), static_cast<char>('0' + I / 10 % 10),
+                      static_cast<char>('0' + I % 10), '\0'};
+    return ctb::string::String{name};
+}();
+
+template<typename>
+struct wide_;
+
+template<::std::size_t... I>
+struct wide_<::std::index_sequence<I...>> {
+    using type = NamedTuple<names<field_name<I>...>, decltype(static_cast<::std::uint32_t>(I))...>;
+};
+
+inline void runtime_test_wide() {
+    using wide = wide_<::std::make_index_sequence<200>>::type;
+    static_assert(SparseNamedTuple<wide>::words_count == 4);
+
+    auto sparse = SparseNamedTuple<wide>{};
+    set<"f199">(sparse, 199u);
+    set<"f070">(sparse, 70u);
+    set<"f130">(sparse, 130u);
+    set<"f003">(sparse, 3u);
+    set<"f064">(sparse, 64u);
+    assert(sparse.size() == 5);
+    assert((sparse.ranks[0] == ::std::array<::std::uint16_t, 4>{0, 1, 3, 4}));
+    assert(sparse.rank<199>() == 4);
+    assert(*get<"f003">(sparse) == 3 && *get<"f064">(sparse) == 64 && *get<"f070">(sparse) == 70);
+    assert(*get<"f130">(sparse) == 130 && *get<"f199">(sparse) == 199);
+
+    erase<"f070">(sparse);
+    assert((sparse.ranks[0] == ::std::array<::std::uint16_t, 4>{0, 1, 2, 3}));
+    assert(get<"f070">(sparse) == nullptr);
+    assert(*get<"f130">(sparse) == 130 && *get<"f199">(sparse) == 199);
+    assert(sparse.bytes() == 4 * sizeof(::std::uint32_t));
+    assert(sparse.values.capacity() * sizeof(SparseNamedTuple<wide>::chunk_type) < sizeof(wide));
+}
+
+using point = NamedTuple<names<"x", "y">, double, double>;
+using mixed = NamedTuple<names<"note", "flag", "level", "pos", "id">, ::std::array<char, 256>, bool, ::std::uint8_t,
+                         point, ::std::uint16_t>;
+
+template<typename T>
+bool is_aligned(T const* ptr) {
+    return reinterpret_cast<::std::uintptr_t>(ptr) % alignof(T) == 0;
+}
+
+inline void runtime_test_mixed() {
+    auto sparse = SparseNamedTuple<mixed>{};
+    set<"id">(sparse, ::std::uint16_t{42});
+    set<"level">(sparse, ::std::uint8_t{3});
+    set<"flag">(sparse, true);
+    assert(sparse.bytes() == 4);
+    // the groups are point, uint16_t, the array and the one-byte fields
+    assert((sparse.bases == ::std::array<::std::size_t, 5>{0, 0, 2, 2, 4}));
+    assert(sparse.values.size() * sizeof(SparseNamedTuple<mixed>::chunk_type) == 8);
+    assert(is_aligned(get<"id">(sparse)));
+
+    set<"pos">(sparse, point{1.5, -2.5});
+    assert(sparse.bytes() == 4 + sizeof(point));
+    assert(is_aligned(get<"pos">(sparse)) && is_aligned(get<"id">(sparse)));
+    assert(get<"x">(*get<"pos">(sparse)) == 1.5 && get<"y">(*get<"pos">(sparse)) == -2.5);
+
+    auto note = ::std::array<char, 256>{};
+    note[0] = 'o';
+    note[255] = 'k';
+    set<"note">(sparse, note);
+    assert(sparse.bytes() == 4 + sizeof(point) + sizeof(note));
+    assert(*get<"note">(sparse) == note);
+    assert(*get<"flag">(sparse) && *get<"level">(sparse) == 3 && *get<"id">(sparse) == 42);
+
+    assert((sparse.bases == ::std::array<::std::size_t, 5>{0, 16, 18, 18 + sizeof(note), 20 + sizeof(note)}));
+
+    erase<"pos">(sparse);
+    assert(sparse.bytes() == 4 + sizeof(note));
+    assert(*get<"note">(sparse) == note && *get<"id">(sparse) == 42 && *get<"level">(sparse) == 3);
+    erase<"note">(sparse);
+    assert(sparse.bytes() == 4 && sparse.values.size() == 1);
+    assert(*get<"flag">(sparse) && *get<"id">(sparse) == 42);
+}
+
+int main() noexcept {
+    runtime_test_sparse();
+    runtime_test_wide();
+    runtime_test_mixed();
+
+    return 0;
+}
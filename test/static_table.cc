@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <string_view>
+#include <ctb/static_table.hh>
+
+using namespace ctb::namedtuple;
+
+constexpr auto countries = static_table<"code">(
+    make_namedtuple<"code", "name">(840, "United States"),
+    make_namedtuple<"code", "name">(156, "China"),
+    make_namedtuple<"code", "name">(250, "France"),
+    make_namedtuple<"code", "name">(276, "Germany"),
+    make_namedtuple<"code", "name">(4, "Afghanistan"));
+
+consteval void test_sorted() noexcept {
+    static_assert(countries.size() == 5);
+    static_assert(::std::ranges::equal(countries.keys, ::std::array{4, 156, 250, 276, 840}));
+    static_assert(::std::string_view{get<"name">(countries.rows[0])} == "Afghanistan");
+}
+
+// a table only builds in constant evaluation when its keys are unique
+template<int... Codes>
+concept has_table = requires {
+    typename ::std::integral_constant<bool, (static_table<"code">(make_namedtuple<"code">(Codes)...), true)>;
+};
+
+consteval void test_duplicate_keys() noexcept {
+    static_assert(has_table<3, 1, 2>);
+    static_assert(!has_table<3, 1, 3>);
+}
+
+consteval void test_find() noexcept {
+    static_assert(::std::string_view{get<"name">(*countries.find<"code">(250))} == "France");
+    static_assert(::std::string_view{get<"name">(*countries.find<"code">(4))} == "Afghanistan");
+    static_assert(::std::string_view{get<"name">(*countries.find<"code">(840))} == "United States");
+    static_assert(countries.find<"code">(251) == nullptr);
+    static_assert(countries.find<"code">(0) == nullptr);
+    static_assert(countries.find<"code">(1000) == nullptr);
+}
+
+// keys this close are equal once converted to double
+constexpr auto wide_keys = static_table<"id">(
+    make_namedtuple<"id", "rank">((::std::uint64_t{1} << 62) + 2, 2),
+    make_namedtuple<"id", "rank">(::std::uint64_t{1} << 62, 0),
+    make_namedtuple<"id", "rank">((::std::uint64_t{1} << 62) + 1, 1));
+
+consteval void test_find_wide_keys() noexcept {
+    static_assert(get<"rank">(*wide_keys.find<"id">(::std::uint64_t{1} << 62)) == 0);
+    static_assert(get<"rank">(*wide_keys.find<"id">((::std::uint64_t{1} << 62) + 1)) == 1);
+    static_assert(get<"rank">(*wide_keys.find<"id">((::std::uint64_t{1} << 62) + 2)) == 2);
+    static_assert(wide_keys.find<"id">((::std::uint64_t{1} << 62) + 3) == nullptr);
+    static_assert(wide_keys.find<"id">((::std::uint64_t{1} << 62) - 1) == nullptr);
+}
+
+inline void runtime_test_find() noexcept {
+    for ([[maybe_unused]] auto const& row : countries) {
+        assert(countries.find<"code">(get<"code">(row)) == &row);
+        assert(countries.find<"code">(get<"code">(row) + 1) == nullptr);
+    }
+    for ([[maybe_unused]] auto const& row : wide_keys) {
+        assert(wide_keys.find<"id">(get<"id">(row)) == &row);
+    }
+}
+
+int main() noexcept {
+    runtime_test_find();
+
+    return 0;
+}
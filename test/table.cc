@@ -0,0 +1,349 @@
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <ctb/table.hh>
+
+using namespace ctb::namedtuple;
+
+using event = NamedTuple<names<"ts", "price", "qty", "total">, long, double, int, double>;
+
+inline void runtime_test_push_back() noexcept {
+    auto table = table_of<event>{};
+    assert(table.size() == 0);
+    table.push_back(event{1l, 2.5, 2, 0.0});
+    table.push_back(event{2l, 1.0, 3, 0.0});
+    assert(table.size() == 2);
+    assert(column<"ts">(table)[1] == 2);
+    assert(get<"qty">(RowRef<table_of<event> const>{&table, 0}) == 2);
+}
+
+/* a value whose copy throws on demand
+ */
+struct fragile {
+    static inline bool fail{};
+    int value;
+
+    // clang-format off
+    fragile(int const value_) noexcept
+        : value{value_}
+    {}
+
+    fragile(fragile const& other)
+        : value{other.value}
+    {
+        if (fail) {
+            throw 0;
+        }
+    }
+
+    // clang-format on
+
+    fragile& operator=(fragile const&) = default;
+};
+
+inline void runtime_test_push_back_rollback() {
+    using row = NamedTuple<names<"ts", "status", "payload">, long, ::std::string, fragile>;
+    auto table = table_of<row>{};
+    table.push_back(row{1l, "OK", fragile{1}});
+
+    auto const failing = row{2l, "ERROR", fragile{2}};
+    fragile::fail = true;
+    try {
+        table.push_back(failing);
+        assert(false);
+    } catch (int) {
+    }
+    fragile::fail = false;
+    assert(column<"ts">(table).size() == 1);
+    assert(column<"status">(table).size() == 1);
+    assert(column<"payload">(table).size() == 1);
+    assert(column<"ts">(table).zones()[0].max == 1);
+
+    table.push_back(row{3l, "OK", fragile{3}});
+    assert(table.size() == 2 && column<"ts">(table)[1] == 3);
+}
+
+inline void runtime_test_parallel() noexcept {
+    constexpr auto rows = ::std::size_t{100'000};
+    auto table = table_of<event>{};
+    table.reserve(rows);
+    for (::std::size_t i{}; i < rows; ++i) {
+        table.push_back(event{static_cast<long>(i), 0.5, static_cast<int>(i % 7), 0.0});
+    }
+
+    parallel_transform<"total">(table, [](auto row) noexcept {
+        return get<"price">(row) * get<"qty">(row);
+    });
+    for (::std::size_t i{}; i < rows; ++i) {
+        assert(column<"total">(table)[i] == 0.5 * static_cast<double>(i % 7));
+    }
+
+    parallel_for_each<"ts">(
+        table,
+        [](auto row) noexcept {
+            get<"ts">(row) *= 2;
+        },
+        3);
+    for (::std::size_t i{}; i < rows; ++i) {
+        assert(column<"ts">(table)[i] == static_cast<long>(2 * i));
+    }
+
+    // single thread
+    parallel_transform<"total">(
+        table,
+        [](auto row) noexcept {
+            return static_cast<double>(get<"qty">(row));
+        },
+        1);
+    assert(column<"total">(table)[rows - 1] == static_cast<double>((rows - 1) % 7));
+}
+
+inline void runtime_test_parallel_throw() {
+    constexpr auto rows = ::std::size_t{100'000};
+    auto table = table_of<event>{};
+    for (::std::size_t i{}; i < rows; ++i) {
+        table.push_back(event{static_cast<long>(i), 0.5, 1, 0.0});
+    }
+
+    // every chunk throws, on the workers and on the calling thread
+    try {
+        parallel_for_each<"ts">(
+            table,
+            [](auto row) {
+                get<"ts">(row) = -get<"ts">(row);
+                if (get<"ts">(row) % 1000 == -999) {
+                    throw ::std::runtime_error{"bad row"};
+                }
+            },
+            4);
+        assert(false);
+    } catch (::std::runtime_error const&) {
+    }
+
+    // the zones cover the rows written before the failure
+    auto const& ts = column<"ts">(table);
+    for (::std::size_t block{}; block < ts.zones().size(); ++block) {
+        auto const first = block * details::zone::block_rows;
+        auto const last = ::std::min(first + details::zone::block_rows, ts.size());
+        [[maybe_unused]] auto const [lo, hi] = ::std::minmax_element(
+            ts.begin() + static_cast<::std::ptrdiff_t>(first), ts.begin() + static_cast<::std::ptrdiff_t>(last));
+        assert(ts.zones()[block].min == *lo && ts.zones()[block].max == *hi);
+    }
+}
+
+inline void runtime_test_zones() noexcept {
+    using reading = NamedTuple<names<"ts", "temp">, long, ::std::optional<int>>;
+    auto table = table_of<reading>{};
+    constexpr auto rows = 3 * details::zone::block_rows + 10;
+    for (::std::size_t i{}; i < rows; ++i) {
+        auto temp = i % 3 == 0 ? ::std::nullopt : ::std::optional<int>{static_cast<int>(i % 100)};
+        table.push_back(reading{static_cast<long>(i), temp});
+    }
+
+    [[maybe_unused]] auto const& ts = column<"ts">(table);
+    assert(ts.zones().size() == 4);
+    assert(ts.zones()[1].min == static_cast<long>(details::zone::block_rows));
+    assert(ts.zones()[1].max == static_cast<long>(2 * details::zone::block_rows - 1));
+    assert(ts.zones()[3].max == static_cast<long>(rows - 1));
+    assert(ts.zones()[0].nulls == 0);
+
+    [[maybe_unused]] auto const& temp = column<"temp">(table);
+    assert(temp.zones()[0].nulls == (details::zone::block_rows + 2) / 3);
+    assert(temp.zones()[0].min == 0);
+    assert(temp.zones()[0].max == 99);
+
+    auto matched = ::std::size_t{};
+    for_each_between<"ts">(table, 5000l, 5009l, [&]([[maybe_unused]] auto row) noexcept {
+        assert(get<"ts">(row) >= 5000 && get<"ts">(row) <= 5009);
+        ++matched;
+    });
+    assert(matched == 10);
+
+    auto expected = ::std::size_t{};
+    for (::std::size_t i{}; i < rows; ++i) {
+        expected += i % 3 != 0 && i % 100 == 1;
+    }
+    matched = 0;
+    for_each_between<"temp">(table, 1, 1, [&]([[maybe_unused]] auto row) noexcept {
+        assert(get<"temp">(row) == 1);
+        ++matched;
+    });
+    assert(matched == expected);
+
+    parallel_for_each<"ts">(table, [](auto row) noexcept {
+        get<"ts">(row) += 1;
+    });
+    assert(ts.zones()[0].min == 1);
+
+    // rows handed out by the queries are read-only, `set` keeps the zones covering what it writes
+    static_assert(::std::is_const_v<::std::remove_reference_t<decltype(get<"ts">(RowRef<decltype(table)>{}))>>);
+    for_each_between<"ts">(table, 1l, 1l, [](auto row) {
+        set<"ts">(row, 100'000l);
+        set<"temp">(row, 1000);
+    });
+    assert(ts.zones()[0].max == 100'000);
+    assert(temp.zones()[0].max == 1000);
+    matched = 0;
+    for_each_between<"ts">(table, 100'000l, 100'000l, [&]([[maybe_unused]] auto row) noexcept {
+        assert(row.index == 0);
+        ++matched;
+    });
+    assert(matched == 1);
+
+    // a block that was all null takes the first value written to it
+    using maybe = NamedTuple<names<"temp">, ::std::optional<int>>;
+    auto sparse = table_of<maybe>{};
+    sparse.push_back(maybe{::std::nullopt});
+    sparse.push_back(maybe{::std::nullopt});
+    set<"temp">(RowRef<decltype(sparse)>{&sparse, 1}, 42);
+    assert(column<"temp">(sparse).zones()[0].nulls == 1);
+    assert(column<"temp">(sparse).zones()[0].min == 42 && column<"temp">(sparse).zones()[0].max == 42);
+}
+
+inline void runtime_test_dictionary() {
+    using request = NamedTuple<names<"status", "region", "latency">, ::std::string, ::std::string_view, int>;
+    auto table = table_of<request>{};
+    char const* const statuses[]{"OK", "NOT_FOUND", "OK", "ERROR", "OK"};
+    for (::std::size_t i{}; i < 1000; ++i) {
+        table.push_back(request{statuses[i % 5], i % 2 == 0 ? "eu" : "us", static_cast<int>(i)});
+    }
+
+    [[maybe_unused]] auto const& status = column<"status">(table);
+    assert(status.size() == 1000);
+    assert(status.distinct() == 3);
+    assert(status.codes().size() == 1000 && status.codes()[3] == *status.find("ERROR"));
+    assert(status[1] == "NOT_FOUND");
+    assert(status[3] == "ERROR");
+    assert(!status.find("MISSING").has_value());
+
+    auto matched = ::std::size_t{};
+    for_each_equal<"status">(table, "OK", [&]([[maybe_unused]] auto row) {
+        assert(get<"status">(row) == "OK");
+        ++matched;
+    });
+    assert(matched == 600);
+    for_each_equal<"status">(table, "MISSING", [](auto) noexcept {
+        assert(false);
+    });
+    matched = 0;
+    for_each_equal<"latency">(table, 7, [&](auto) noexcept {
+        ++matched;
+    });
+    assert(matched == 1);
+
+    auto const counts = count_by<"region">(table);
+    [[maybe_unused]] auto const& region = column<"region">(table);
+    assert(counts.size() == 2);
+    assert(counts[*region.find("eu")] == 500);
+    assert(counts[*region.find("us")] == 500);
+
+    for (::std::size_t i{}; i < 100; ++i) {
+        table.push_back(request{::std::to_string(i), "eu", 0});
+    }
+    assert(status.distinct() == 103);
+    assert(status[1050] == "50");
+    assert(*status.find("99") == 102);
+
+    // running out of codes throws instead of reusing one
+    auto narrow = DictionaryColumn<char, ::std::uint8_t>{};
+    for (auto i = 0; i < 255; ++i) {
+        narrow.push_back(::std::to_string(i));
+    }
+    narrow.push_back("0");
+    try {
+        narrow.push_back("255");
+        assert(false);
+    } catch (::std::length_error const&) {
+    }
+    assert(narrow.distinct() == 255 && narrow.size() == 256);
+    assert(narrow[254] == "254" && *narrow.find("254") == 254);
+}
+
+// views borrow from tables the caller keeps, and from any view
+template<typename T>
+concept can_project = requires(T&& table) { project<"qty">(::std::forward<T>(table)); };
+
+consteval void test_views() noexcept {
+    using view = TableView<names<"qty">, int>;
+    static_assert(can_project<table_of<event>&>);
+    static_assert(!can_project<table_of<event>>);
+    static_assert(!can_project<table_of<event> const&>);
+    static_assert(can_project<view>);
+    static_assert(can_project<view const&>);
+}
+
+inline void runtime_test_views() {
+    auto table = table_of<event>{};
+    table.push_back(event{1l, 2.5, 2, 0.0});
+    table.push_back(event{2l, 1.0, 3, 0.0});
+
+    auto renamed = rename<"ts", "timestamp">(table);
+    static_assert(::std::is_same_v<decltype(renamed)::names, names<"timestamp", "price", "qty", "total">>);
+    assert(&column<"timestamp">(renamed) == &column<"ts">(table));
+    assert(renamed.size() == 2);
+
+    auto projected = project<"qty", "price">(renamed);
+    static_assert(::std::is_same_v<decltype(projected), TableView<names<"qty", "price">, int, double>>);
+    assert(&column<0>(projected) == &column<"qty">(table));
+    assert(column<"price">(projected)[1] == 1.0);
+
+    auto chained = project<"timestamp", "qty">(rename<"ts", "timestamp">(table));
+    static_assert(::std::is_same_v<decltype(chained), TableView<names<"timestamp", "qty">, long, int>>);
+    assert(&column<"timestamp">(chained) == &column<"ts">(table));
+    assert(column<"qty">(chained)[0] == 2);
+
+    // writes through a view land in the table
+    parallel_for_each<"qty">(projected, [](auto row) noexcept {
+        get<"qty">(row) *= 10;
+    });
+    assert(column<"qty">(table)[1] == 30);
+    assert(column<"qty">(table).zones()[0].max == 30);
+
+    parallel_transform<"total">(renamed, [](auto row) noexcept {
+        return get<"price">(row) * get<"qty">(row);
+    });
+    assert(column<"total">(table)[0] == 50.0);
+
+    auto matched = ::std::size_t{};
+    for_each_between<"timestamp">(renamed, 2l, 2l, [&]([[maybe_unused]] auto row) noexcept {
+        assert(get<"price">(row) == 1.0);
+        ++matched;
+    });
+    assert(matched == 1);
+
+    using request = NamedTuple<names<"status", "latency">, ::std::string, int>;
+    auto requests = table_of<request>{};
+    requests.push_back(request{"OK", 1});
+    requests.push_back(request{"ERROR", 2});
+    [[maybe_unused]] auto statuses = project<"status">(requests);
+    assert(count_by<"status">(statuses).size() == 2);
+}
+
+inline void runtime_test_shredded() noexcept {
+    using location = NamedTuple<names<"lat", "lon">, double, double>;
+    using reading = NamedTuple<names<"ts", "at", "temp">, long, location, int>;
+    auto table = shredded_table_of<reading>{};
+    table.push_back(flatten(reading{1l, location{1.5, 2.5}, 20}));
+    table.push_back(flatten(reading{2l, location{3.5, 4.5}, 21}));
+    assert(column<"at.lon">(table)[1] == 4.5);
+    assert(column<"at.lat">(table).zones()[0].max == 3.5);
+    assert(get<"at.lat">(RowRef<decltype(table)>{&table, 0}) == 1.5);
+}
+
+int main() noexcept {
+    runtime_test_push_back();
+    runtime_test_push_back_rollback();
+    runtime_test_parallel();
+    runtime_test_parallel_throw();
+    runtime_test_zones();
+    runtime_test_dictionary();
+    runtime_test_views();
+    runtime_test_shredded();
+
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+#include <ctb/wire.hh>
+
+using namespace ctb::namedtuple;
+
+enum class level : unsigned char { debug, info, error };
+
+using inner = NamedTuple<names<"host", "port">, ::std::string, unsigned short>;
+using message =
+    NamedTuple<names<"id", "delta", "ok", "ratio", "scale", "level", "tag", "peer">, unsigned long long, int, bool,
+               double, float, level, ctb::string::String<char, 8>, inner>;
+
+consteval void test_varint() noexcept {
+    static_assert(details::wire::zigzag(0) == 0);
+    static_assert(details::wire::zigzag(-1) == 1);
+    static_assert(details::wire::zigzag(1) == 2);
+    static_assert(details::wire::zigzag(-2) == 3);
+    static_assert(details::wire::unzigzag(details::wire::zigzag(-123456789)) == -123456789);
+    static_assert(details::wire::unzigzag(details::wire::zigzag(INT64_MIN)) == INT64_MIN);
+    static_assert(details::wire::unzigzag(details::wire::zigzag(INT64_MAX)) == INT64_MAX);
+
+    static_assert([] {
+        ::std::byte bytes[details::wire::max_varint_size]{};
+        auto const size = details::wire::put_varint(300, bytes);
+        auto in = details::wire::reader{{bytes, bytes + size}};
+        ::std::uint64_t value{};
+        return size == 2 && bytes[0] == ::std::byte{0xac} && bytes[1] == ::std::byte{0x02} && in.varint(value) &&
+               value == 300;
+    }());
+    static_assert([] {
+        ::std::byte bytes[details::wire::max_varint_size]{};
+        auto const size = details::wire::put_varint(UINT64_MAX, bytes);
+        auto in = details::wire::reader{{bytes, bytes + size}};
+        ::std::uint64_t value{};
+        return size == 10 && in.varint(value) && value == UINT64_MAX;
+    }());
+}
+
+inline void runtime_test_protobuf_bytes() {
+    // the example of the protobuf encoding guide: field 1 = 150
+    auto bytes = ::std::vector<::std::byte>{};
+    encode_wire(NamedTuple<names<"a">, unsigned>{150u}, bytes);
+    assert((bytes == ::std::vector{::std::byte{0x08}, ::std::byte{0x96}, ::std::byte{0x01}}));
+
+    bytes.clear();
+    encode_wire(NamedTuple<names<"a", "b">, int, float>{-1, 1.0f}, bytes);
+    assert((bytes == ::std::vector{::std::byte{0x08}, ::std::byte{0x01}, ::std::byte{0x15}, ::std::byte{0x00},
+                                   ::std::byte{0x00}, ::std::byte{0x80}, ::std::byte{0x3f}}));
+}
+
+enum class delta : int { down = -1, same, up };
+
+inline void runtime_test_enum_bytes() {
+    // enums are plain varints as in protobuf, a negative one sign extended to 10 bytes
+    auto bytes = ::std::vector<::std::byte>{};
+    encode_wire(NamedTuple<names<"a">, delta>{delta::up}, bytes);
+    assert((bytes == ::std::vector{::std::byte{0x08}, ::std::byte{0x01}}));
+
+    bytes.clear();
+    encode_wire(NamedTuple<names<"a">, delta>{delta::down}, bytes);
+    assert(bytes.size() == 11 && bytes[1] == ::std::byte{0xff} && bytes[10] == ::std::byte{0x01});
+
+    auto decoded = NamedTuple<names<"a">, delta>{delta::same};
+    [[maybe_unused]] auto decoded_ok = decode_wire(decoded, ::std::span{bytes});
+    assert(decoded_ok && get<"a">(decoded) == delta::down);
+
+    // out of the range of the underlying type
+    bytes = {::std::byte{0x08}, ::std::byte{0x80}, ::std::byte{0x02}};
+    auto small = NamedTuple<names<"a">, level>{level::info};
+    decoded_ok = decode_wire(small, ::std::span{bytes});
+    assert(!decoded_ok);
+}
+
+inline void runtime_test_round_trip() {
+    auto const original = message{42ull, -7, true, 0.25, -1.5f, level::error, ctb::string::String{"edge\0\0\0"},
+                                  inner{::std::string(200, 'h'), static_cast<unsigned short>(8080)}};
+    auto bytes = ::std::vector<::std::byte>{};
+    encode_wire(original, bytes);
+
+    auto decoded = message{0ull, 0, false, 0.0, 0.0f, level::debug, ctb::string::String{"1234567"},
+                           inner{::std::string{}, static_cast<unsigned short>(0)}};
+    [[maybe_unused]] auto decoded_ok = decode_wire(decoded, ::std::span{bytes});
+    assert(decoded_ok);
+    assert(get<"id">(decoded) == 42);
+    assert(get<"delta">(decoded) == -7);
+    assert(get<"ok">(decoded));
+    assert(get<"ratio">(decoded) == 0.25);
+    assert(get<"scale">(decoded) == -1.5f);
+    assert(get<"level">(decoded) == level::error);
+    assert(get<"tag">(decoded) == "edge");
+    assert(get<"host">(get<"peer">(decoded)) == ::std::string(200, 'h'));
+    assert(get<"port">(get<"peer">(decoded)) == 8080);
+
+    // a String can be filled up to its capacity
+    using tagged = NamedTuple<names<"tag">, ctb::string::String<char, 8>>;
+    auto full = ::std::vector<::std::byte>{};
+    encode_wire(tagged{ctb::string::String{"1234567"}}, full);
+    auto filled = tagged{ctb::string::String{"edge\0\0\0"}};
+    decoded_ok = decode_wire(filled, ::std::span{full});
+    assert(decoded_ok);
+    assert(get<"tag">(filled) == "1234567");
+
+    // a truncated message is rejected
+    decoded_ok = decode_wire(decoded, ::std::span{bytes}.first(bytes.size() - 1));
+    assert(!decoded_ok);
+}
+
+inline void runtime_test_schema_evolution() {
+    using v1 = NamedTuple<names<"id", "name">, long, ::std::string>;
+    using v2 = NamedTuple<names<"id", "name", "score">, long, ::std::string, double>;
+
+    auto bytes = ::std::vector<::std::byte>{};
+    encode_wire(v2{-3l, ::std::string{"x"}, 1.5}, bytes);
+    auto old = v1{0l, ::std::string{}};
+    // the unknown field is skipped
+    [[maybe_unused]] auto decoded_ok = decode_wire(old, ::std::span{bytes});
+    assert(decoded_ok);
+    assert(get<"id">(old) == -3);
+    assert(get<"name">(old) == "x");
+
+    bytes.clear();
+    encode_wire(old, bytes);
+    auto newer = v2{0l, ::std::string{}, 9.0};
+    // the missing field keeps its value
+    decoded_ok = decode_wire(newer, ::std::span{bytes});
+    assert(decoded_ok);
+    assert(get<"id">(newer) == -3);
+    assert(get<"score">(newer) == 9.0);
+
+    // a value out of range of the field is rejected
+    bytes.clear();
+    encode_wire(NamedTuple<names<"a">, int>{300}, bytes);
+    auto narrow = NamedTuple<names<"a">, signed char>{static_cast<signed char>(0)};
+    decoded_ok = decode_wire(narrow, ::std::span{bytes});
+    assert(!decoded_ok);
+}
+
+int main() noexcept {
+    runtime_test_protobuf_bytes();
+    runtime_test_enum_bytes();
+    runtime_test_round_trip();
+    runtime_test_schema_evolution();
+
+    return 0;
+}
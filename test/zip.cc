@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <ctb/zip.hh>
+
+using namespace ctb::namedtuple;
+
+using view = decltype(zip_named<"ts", "value">(::std::declval<::std::vector<long>&>(),
+                                               ::std::declval<::std::vector<double> const&>()));
+
+consteval void test_concepts() noexcept {
+    static_assert(::std::random_access_iterator<view::iterator>);
+    static_assert(::std::ranges::random_access_range<view>);
+    static_assert(::std::ranges::sized_range<view>);
+    static_assert(::std::ranges::view<view>);
+    static_assert(::std::ranges::borrowed_range<view>);
+    static_assert(::std::is_same_v<::std::ranges::range_reference_t<view>,
+                                   NamedTuple<names<"ts", "value">, long&, double const&>>);
+    static_assert(::std::is_same_v<::std::ranges::range_value_t<view>, NamedTuple<names<"ts", "value">, long, double>>);
+}
+
+inline void runtime_test_zip() {
+    auto ts = ::std::vector<long>{5, 1, 4, 2, 3};
+    auto const values = ::std::vector<double>{0.5, 1.5, 2.5, 3.5, 4.5, 99.0};
+    auto const rows = zip_named<"ts", "value">(ts, values);
+    assert(rows.size() == 5);
+    assert(get<"value">(rows[2]) == 2.5);
+    assert(&get<"ts">(rows.front()) == &ts[0]);
+
+    [[maybe_unused]] auto const found = ::std::ranges::find_if(rows, [](auto row) {
+        return get<"value">(row) > 3.0;
+    });
+    assert(found - rows.begin() == 3);
+    assert(get<"ts">(*found) == 2);
+
+    [[maybe_unused]] auto const latest = ::std::ranges::max_element(rows, {}, [](auto row) {
+        return get<"ts">(row);
+    });
+    assert(get<"value">(*latest) == 0.5);
+    assert(::std::ranges::count_if(rows, [](auto row) { return get<"ts">(row) % 2 == 1; }) == 3);
+
+    for (auto row : rows | ::std::views::reverse | ::std::views::take(2)) {
+        get<"ts">(row) *= 10;
+    }
+    assert(ts[4] == 30 && ts[3] == 20 && ts[2] == 4);
+
+    // a row can be copied out as values
+    [[maybe_unused]] ::std::ranges::range_value_t<decltype(rows)> const copy = rows[1];
+    ts[1] = 100;
+    assert(get<"ts">(copy) == 1);
+
+    auto names_ = ::std::vector<::std::string>{"a", "b"};
+    for (auto row : zip_named<"name", "ts">(names_, ts)) {
+        get<"name">(row) += ::std::to_string(get<"ts">(row));
+    }
+    assert(names_[0] == "a5" && names_[1] == "b100");
+}
+
+int main() noexcept {
+    runtime_test_zip();
+
+    return 0;
+}